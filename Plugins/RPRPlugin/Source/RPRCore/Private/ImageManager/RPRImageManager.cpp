@@ -21,14 +21,210 @@
 #include "Helpers/RPRImageHelpers.h"
 #include "RPRSettings.h"
 #include "Helpers/RPRTextureHelpers.h"
+#include "Helpers/RPRScratchMemory.h"
+#include "Helpers/RPRMemoryReport.h"
+#include "Helpers/RPRTrace.h"
 #include "RPRCoreModule.h"
 #include "Runtime/Launch/Resources/Version.h"
+#include "Async/ParallelFor.h"
+#include "Math/VectorRegister.h"
 
 DECLARE_LOG_CATEGORY_CLASS(LogRPRImageManager, Log, All)
 
+namespace
+{
+#if ENGINE_MINOR_VERSION >= 24
+	typedef TArray64<uint8>	FUnwrapData;
+#else
+	typedef TArray<uint8>	FUnwrapData;
+#endif
+
+	// Unwraps of older sources are dropped once there are more
+	const int32	MaxUnwrappedCubemaps = 4;
+
+	FORCEINLINE VectorRegister	LoadTexel(const FFloat16Color& Texel)
+	{
+		return VectorSet(Texel.R.GetFloat(), Texel.G.GetFloat(), Texel.B.GetFloat(), Texel.A.GetFloat());
+	}
+
+	FORCEINLINE VectorRegister	LoadTexel(const FColor& Texel)
+	{
+		return VectorSet(float(Texel.R), float(Texel.G), float(Texel.B), float(Texel.A));
+	}
+
+	FORCEINLINE void	StoreTexel(const VectorRegister& Value, FFloat16Color& OutTexel)
+	{
+		FLinearColor	color;
+		VectorStore(Value, &color.R);
+		OutTexel = FFloat16Color(color);
+	}
+
+	FORCEINLINE void	StoreTexel(const VectorRegister& Value, FColor& OutTexel)
+	{
+		FLinearColor	color;
+		VectorStore(VectorAdd(Value, VectorSetFloat1(0.5f)), &color.R);
+		OutTexel = FColor(
+			uint8(FMath::Clamp(FMath::TruncToInt(color.R), 0, 255)),
+			uint8(FMath::Clamp(FMath::TruncToInt(color.G), 0, 255)),
+			uint8(FMath::Clamp(FMath::TruncToInt(color.B), 0, 255)),
+			uint8(FMath::Clamp(FMath::TruncToInt(color.A), 0, 255)));
+	}
+
+	FORCEINLINE VectorRegister	LerpTexels(const VectorRegister& A, const VectorRegister& B, float Alpha)
+	{
+		return VectorMultiplyAdd(VectorSubtract(B, A), VectorSetFloat1(Alpha), A);
+	}
+
+	/*
+	* Bilinear sample of the cube faces (+X, -X, +Y, -Y, +Z, -Z), using the D3D face orientations.
+	*/
+	template<typename TTexel>
+	VectorRegister	SampleCube(const TTexel* Faces, int32 FaceSize, const FVector& Direction)
+	{
+		const float	absX = FMath::Abs(Direction.X);
+		const float	absY = FMath::Abs(Direction.Y);
+		const float	absZ = FMath::Abs(Direction.Z);
+
+		int32	face;
+		float	major, s, t;
+		if (absX >= absY && absX >= absZ)
+		{
+			face = Direction.X > 0.0f ? 0 : 1;
+			major = absX;
+			s = Direction.X > 0.0f ? -Direction.Z : Direction.Z;
+			t = -Direction.Y;
+		}
+		else if (absY >= absZ)
+		{
+			face = Direction.Y > 0.0f ? 2 : 3;
+			major = absY;
+			s = Direction.X;
+			t = Direction.Y > 0.0f ? Direction.Z : -Direction.Z;
+		}
+		else
+		{
+			face = Direction.Z > 0.0f ? 4 : 5;
+			major = absZ;
+			s = Direction.Z > 0.0f ? Direction.X : -Direction.X;
+			t = -Direction.Y;
+		}
+
+		const float	x = (s / major + 1.0f) * 0.5f * FaceSize - 0.5f;
+		const float	y = (t / major + 1.0f) * 0.5f * FaceSize - 0.5f;
+		const int32	x0 = FMath::Clamp(FMath::FloorToInt(x), 0, FaceSize - 1);
+		const int32	y0 = FMath::Clamp(FMath::FloorToInt(y), 0, FaceSize - 1);
+		const int32	x1 = FMath::Min(x0 + 1, FaceSize - 1);
+		const int32	y1 = FMath::Min(y0 + 1, FaceSize - 1);
+		const float	alphaX = FMath::Clamp(x - x0, 0.0f, 1.0f);
+		const float	alphaY = FMath::Clamp(y - y0, 0.0f, 1.0f);
+
+		const TTexel*	texels = Faces + int64(face) * FaceSize * FaceSize;
+		const TTexel*	row0 = texels + int64(y0) * FaceSize;
+		const TTexel*	row1 = texels + int64(y1) * FaceSize;
+		const VectorRegister	top = LerpTexels(LoadTexel(row0[x0]), LoadTexel(row0[x1]), alphaX);
+		const VectorRegister	bottom = LerpTexels(LoadTexel(row1[x0]), LoadTexel(row1[x1]), alphaX);
+		return LerpTexels(top, bottom, alphaY);
+	}
+
+	/*
+	* Same projection as CubemapHelpers::GenerateLongLatUnwrap, computed on the CPU one row per task.
+	*/
+	template<typename TTexel>
+	void	UnwrapCubeFaces(const TTexel* Faces, int32 FaceSize, int32 Width, int32 Height, TTexel* OutTexels)
+	{
+		TArray<FVector2D>	columns;
+		columns.SetNumUninitialized(Width);
+		for (int32 x = 0; x < Width; ++x)
+		{
+			const float	angle = 2.0f * PI * ((x + 0.5f) / Width + 0.5f);
+			columns[x] = FVector2D(FMath::Sin(angle), FMath::Cos(angle));
+		}
+
+		ParallelFor(Height, [&columns, Faces, FaceSize, Width, Height, OutTexels](int32 y)
+		{
+			const float	angle = PI * (y + 0.5f) / Height;
+			const float	sinAngle = FMath::Sin(angle);
+			const float	cosAngle = FMath::Cos(angle);
+
+			TTexel*	row = OutTexels + int64(y) * Width;
+			for (int32 x = 0; x < Width; ++x)
+			{
+				const FVector	direction(sinAngle * columns[x].X, -sinAngle * columns[x].Y, cosAngle);
+				StoreTexel(SampleCube(Faces, FaceSize, direction), row[x]);
+			}
+		});
+	}
+
+	/*
+	* Bilinear resize of a long-lat image, wrapping horizontally.
+	*/
+	template<typename TTexel>
+	void	ResizeLongLat(const TTexel* Texels, int32 SrcWidth, int32 SrcHeight, int32 Width, int32 Height, TTexel* OutTexels)
+	{
+		ParallelFor(Height, [Texels, SrcWidth, SrcHeight, Width, Height, OutTexels](int32 y)
+		{
+			const float	srcY = (y + 0.5f) * SrcHeight / Height - 0.5f;
+			const int32	y0 = FMath::Clamp(FMath::FloorToInt(srcY), 0, SrcHeight - 1);
+			const int32	y1 = FMath::Min(y0 + 1, SrcHeight - 1);
+			const float	alphaY = FMath::Clamp(srcY - y0, 0.0f, 1.0f);
+			const TTexel*	row0 = Texels + int64(y0) * SrcWidth;
+			const TTexel*	row1 = Texels + int64(y1) * SrcWidth;
+
+			TTexel*	row = OutTexels + int64(y) * Width;
+			for (int32 x = 0; x < Width; ++x)
+			{
+				const float	srcX = (x + 0.5f) * SrcWidth / Width - 0.5f;
+				const int32	floorX = FMath::FloorToInt(srcX);
+				const int32	x0 = (floorX + SrcWidth) % SrcWidth;
+				const int32	x1 = (x0 + 1) % SrcWidth;
+				const float	alphaX = srcX - floorX;
+
+				const VectorRegister	top = LerpTexels(LoadTexel(row0[x0]), LoadTexel(row0[x1]), alphaX);
+				const VectorRegister	bottom = LerpTexels(LoadTexel(row1[x0]), LoadTexel(row1[x1]), alphaX);
+				StoreTexel(LerpTexels(top, bottom, alphaY), row[x]);
+			}
+		});
+	}
+
+	/*
+	* Copies or resizes a long-lat source, RGBE (.hdr imports) is decoded to half floats.
+	*/
+	template<typename TTexel>
+	void	CopyLongLat(const TTexel* Texels, int32 SrcWidth, int32 SrcHeight, int32 Width, int32 Height, FUnwrapData& OutData)
+	{
+		OutData.SetNumUninitialized(int64(Width) * Height * sizeof(TTexel));
+		if (SrcWidth == Width && SrcHeight == Height)
+		{
+			FMemory::Memcpy(OutData.GetData(), Texels, OutData.Num());
+			return;
+		}
+		ResizeLongLat(Texels, SrcWidth, SrcHeight, Width, Height, reinterpret_cast<TTexel*>(OutData.GetData()));
+	}
+
+	void	DecodeRGBE(const FColor* Texels, int64 TexelCount, TArray<FFloat16Color>& OutTexels)
+	{
+		OutTexels.SetNumUninitialized(TexelCount);
+		ParallelFor(int32((TexelCount + 4095) / 4096), [Texels, TexelCount, &OutTexels](int32 iBlock)
+		{
+			const int64	end = FMath::Min(int64(iBlock + 1) * 4096, TexelCount);
+			for (int64 i = int64(iBlock) * 4096; i < end; ++i)
+			{
+				OutTexels[i] = FFloat16Color(Texels[i].FromRGBE());
+			}
+		});
+	}
+}
+
 namespace RPR
 {
 
+	struct FImageManager::FUnwrappedCubemap
+	{
+		FUnwrapData		Data;
+		FIntPoint		Size;
+		EPixelFormat	Format;
+	};
+
 	FImageManager::FImageManager(RPR::FContext RPRContext)
 		: context(RPRContext)
 	{}
@@ -66,6 +262,8 @@ namespace RPR
 			return (imagePtr);
 		}
 
+		RPR_TRACE_SCOPE_DETAIL("Load image", *Texture->GetName());
+
 		// BuildImage should (will be later) some kind of caching system (done before packaging ?)
 		// Avoid building several times the same image, and runtime data is compressed or not accessible
 		Texture->ConditionalPostLoad();
@@ -93,9 +291,11 @@ namespace RPR
 			return nullptr;
 		}
 
-		FByteBulkData &mipData = platformData->Mips[0].BulkData;
+		const int32			firstMip = SelectFirstMip(platformData, componentSize * dstFormat.num_components);
+		FTexture2DMipMap	&mip = platformData->Mips[firstMip];
+		FByteBulkData &mipData = mip.BulkData;
 		const uint32  bulkDataSize = mipData.GetBulkDataSize();
-		if (platformData->SizeX <= 0 || bulkDataSize <= 0)
+		if (mip.SizeX <= 0 || bulkDataSize <= 0)
 		{
 			UE_LOG(LogRPRImageManager, Warning, TEXT("Couldn't build image: empty PlatformData Mips BulkData"));
 			return nullptr;
@@ -108,16 +308,24 @@ namespace RPR
 			return nullptr;
 		}
 
+		if (firstMip > 0)
+		{
+			UE_LOG(LogRPRImageManager, Verbose, TEXT("Loading '%s' from mip %d (%dx%d)"), *Texture->GetName(), firstMip, mip.SizeX, mip.SizeY);
+		}
+
 		FImageDesc	desc;
-		desc.image_width = platformData->SizeX;
-		desc.image_height = platformData->SizeY;
+		desc.image_width = mip.SizeX;
+		desc.image_height = mip.SizeY;
 		desc.image_depth = 1;
 		desc.image_row_pitch = desc.image_width * componentSize * dstFormat.num_components;
 		desc.image_slice_pitch = 0;
 
+		// rprContextCreateImage copies the data, the converted pixels only live until the end of this load
+		FMemMark	mark(FMemStack::Get());
 		const uint32	totalByteCount = desc.image_row_pitch * desc.image_height;
-		TArray<uint8>	rprData;
-		rprData.SetNum(totalByteCount);
+		ScratchMemory::TScratchArray<uint8>	rprData;
+		rprData.SetNumZeroed(totalByteCount);
+		ScratchMemory::TrackUsage();
 
 		bool bAreTextureCopied = RPR::FTextureHelpers::CopyTexture(static_cast<const uint8*>(textureDataReadOnly), bulkDataSize, desc, rprData, platformData->PixelFormat, Texture->SRGB);
 		mipData.Unlock();
@@ -132,6 +340,7 @@ namespace RPR
 		RPR::FResult status = rprContextCreateImage(context, dstFormat, &desc, rprData.GetData(), &image);
 		if (status != RPR_SUCCESS) {
 			UE_LOG(LogRPRImageManager, Error, TEXT("rprContextCreateImage failed"));
+			RPR::Memory::LogOutOfMemory(status, Texture->GetPathName());
 			return nullptr;
 		}
 
@@ -144,6 +353,7 @@ namespace RPR
 		}
 
 		imagePtr = MakeShareable(image, TImageDeleter());
+		RPR::Memory::Track(image, RPR::Memory::ECategory::Image, totalByteCount, Texture->GetPathName());
 
 		RPR::EImageWrapType imageWrapType = RPR::Image::ConvertUE4TextureAddressToRPRImageWrap(Texture->AddressX.GetValue());
 		status = SetImageWrapType(image, imageWrapType);
@@ -169,22 +379,21 @@ namespace RPR
 			return (imagePtr);
 		}
 
+		RPR_TRACE_SCOPE_DETAIL("Load cube image", *Texture->GetName());
+
 		// BuildCubeImage should (will be later) some kind of caching system (done before packaging ?)
 		// Avoid building several times the same image, and runtime data is compressed or not accessible
 		Texture->ConditionalPostLoad();
 
-#if ENGINE_MINOR_VERSION >= 24
-		TArray64<uint8>	srcData;
-#else
-		TArray<uint8>   srcData;
-#endif
-		FIntPoint		srcSize;
-		EPixelFormat	srcFormat;
-		if (!CubemapHelpers::GenerateLongLatUnwrap(Cast<UTextureCube>(Texture), srcData, srcSize, srcFormat))
+		TSharedPtr<const FUnwrappedCubemap>	unwrap = FindOrUnwrapCubemap(Texture);
+		if (!unwrap.IsValid())
 		{
 			UE_LOG(LogRPRImageManager, Warning, TEXT("Couldn't build cubemap"));
 			return TryLoadErrorTexture();
 		};
+		const FUnwrapData&	srcData = unwrap->Data;
+		const FIntPoint		srcSize = unwrap->Size;
+		const EPixelFormat	srcFormat = unwrap->Format;
 		if (srcSize.X <= 0 || srcSize.Y <= 0)
 		{
 			UE_LOG(LogRPRImageManager, Warning, TEXT("Couldn't build cubemap: empty texture"));
@@ -205,26 +414,132 @@ namespace RPR
 		desc.image_row_pitch = desc.image_width * componentSize * dstFormat.num_components;
 		desc.image_slice_pitch = 0;
 
+		FMemMark	mark(FMemStack::Get());
 		const uint32	totalByteCount = desc.image_row_pitch * desc.image_height;
-		TArray<uint8>	rprData;
-		rprData.SetNum(totalByteCount);
+		ScratchMemory::TScratchArray<uint8>	rprData;
+		rprData.SetNumZeroed(totalByteCount);
+		ScratchMemory::TrackUsage();
 
 		//ConvertPixels(srcData.GetData(), rprData, srcFormat, desc.image_width * desc.image_height);
 		RPR::FTextureHelpers::CopyTexture(srcData.GetData(), srcData.GetAllocatedSize(), desc, rprData, srcFormat, Texture->SRGB);
 
 		RPR::FImage image;
-		if (RPR::IsResultFailed(rprContextCreateImage(context, dstFormat, &desc, rprData.GetData(), &image)))
+		RPR::FResult status = rprContextCreateImage(context, dstFormat, &desc, rprData.GetData(), &image);
+		if (RPR::IsResultFailed(status))
 		{
 			UE_LOG(LogRPRImageManager, Warning, TEXT("Couldn't create RPR image"));
+			RPR::Memory::LogOutOfMemory(status, Texture->GetPathName());
 			return TryLoadErrorTexture();
 		}
 
 		imagePtr = MakeShareable(image, TImageDeleter());
+		RPR::Memory::Track(image, RPR::Memory::ECategory::Image, totalByteCount, Texture->GetPathName());
 
 		cache.Add(Texture, imagePtr);
 		return imagePtr;
 	}
 
+	/*
+	* Unwraps the cubemap source faces on the CPU when the editor data is there (BGRA8 and RGBA16F sources),
+	* otherwise lets the engine unwrap the platform data.
+	* Cubemaps imported from a long-lat image (.hdr skies) keep it as their source, it is used as is.
+	* Width comes from EnvironmentMapWidth, or twice the face size (the source width for long-lat), capped by MaxTextureResolution.
+	*/
+	TSharedPtr<const FImageManager::FUnwrappedCubemap> FImageManager::FindOrUnwrapCubemap(UTextureCube* Texture)
+	{
+		auto	addToCache = [this](const FString& Key, const TSharedPtr<const FUnwrappedCubemap>& Unwrap)
+		{
+			unwrappedCubemaps.Add(Key, Unwrap);
+			unwrappedCubemapsOrder.Add(Key);
+			while (unwrappedCubemapsOrder.Num() > MaxUnwrappedCubemaps)
+			{
+				unwrappedCubemaps.Remove(unwrappedCubemapsOrder[0]);
+				unwrappedCubemapsOrder.RemoveAt(0);
+			}
+		};
+
+		TSharedPtr<FUnwrappedCubemap>	unwrap = MakeShared<FUnwrappedCubemap>();
+
+#if WITH_EDITORONLY_DATA
+		FTextureSource&				source = Texture->Source;
+		const ETextureSourceFormat	sourceFormat = source.GetFormat();
+		const bool	isSupportedFormat = sourceFormat == TSF_BGRA8 || sourceFormat == TSF_RGBA16F;
+		const bool	isCubeFaces = source.GetNumSlices() == 6 && isSupportedFormat;
+		const bool	isLongLat = source.GetNumSlices() == 1 && (isSupportedFormat || sourceFormat == TSF_BGRE8);
+		if (source.IsValid() && (isCubeFaces || isLongLat))
+		{
+			const URPRSettings	*settings = GetDefault<URPRSettings>();
+			const int32			srcWidth = source.GetSizeX();
+			const int32			srcHeight = source.GetSizeY();
+
+			int32	width = settings->EnvironmentMapWidth > 0 ? settings->EnvironmentMapWidth : (isLongLat ? srcWidth : srcWidth * 2);
+			if (settings->MaxTextureResolution > 0)
+			{
+				width = FMath::Min(width, settings->MaxTextureResolution);
+			}
+			width = FMath::Max(width & ~1, 2);
+			const int32	height = width / 2;
+
+			const FString	key = FString::Printf(TEXT("%s_%d"), *source.GetId().ToString(), width);
+			if (const TSharedPtr<const FUnwrappedCubemap>* cached = unwrappedCubemaps.Find(key))
+			{
+				return *cached;
+			}
+
+			RPR_TRACE_SCOPE_DETAIL("Unwrap cubemap", *Texture->GetName());
+
+			const int64	texelSize = sourceFormat == TSF_RGBA16F ? sizeof(FFloat16Color) : sizeof(FColor);
+			const int64	texelCount = int64(srcWidth) * srcHeight * source.GetNumSlices();
+			FUnwrapData	srcData;
+			source.GetMipData(srcData, 0);
+			if (srcData.Num() >= texelCount * texelSize)
+			{
+				unwrap->Size = FIntPoint(width, height);
+				unwrap->Format = sourceFormat == TSF_BGRA8 ? PF_B8G8R8A8 : PF_FloatRGBA;
+				if (isLongLat && sourceFormat == TSF_BGRE8)
+				{
+					TArray<FFloat16Color>	decoded;
+					DecodeRGBE(reinterpret_cast<const FColor*>(srcData.GetData()), texelCount, decoded);
+					CopyLongLat(decoded.GetData(), srcWidth, srcHeight, width, height, unwrap->Data);
+				}
+				else if (isLongLat && sourceFormat == TSF_RGBA16F)
+				{
+					CopyLongLat(reinterpret_cast<const FFloat16Color*>(srcData.GetData()), srcWidth, srcHeight, width, height, unwrap->Data);
+				}
+				else if (isLongLat)
+				{
+					CopyLongLat(reinterpret_cast<const FColor*>(srcData.GetData()), srcWidth, srcHeight, width, height, unwrap->Data);
+				}
+				else if (sourceFormat == TSF_RGBA16F)
+				{
+					unwrap->Data.SetNumUninitialized(int64(width) * height * texelSize);
+					UnwrapCubeFaces(reinterpret_cast<const FFloat16Color*>(srcData.GetData()), srcWidth, width, height, reinterpret_cast<FFloat16Color*>(unwrap->Data.GetData()));
+				}
+				else
+				{
+					unwrap->Data.SetNumUninitialized(int64(width) * height * texelSize);
+					UnwrapCubeFaces(reinterpret_cast<const FColor*>(srcData.GetData()), srcWidth, width, height, reinterpret_cast<FColor*>(unwrap->Data.GetData()));
+				}
+				addToCache(key, unwrap);
+				return unwrap;
+			}
+		}
+#endif
+
+		const FString	key = FString::Printf(TEXT("%s_engine"), *Texture->GetLightingGuid().ToString());
+		if (const TSharedPtr<const FUnwrappedCubemap>* cached = unwrappedCubemaps.Find(key))
+		{
+			return *cached;
+		}
+
+		if (!CubemapHelpers::GenerateLongLatUnwrap(Texture, unwrap->Data, unwrap->Size, unwrap->Format))
+		{
+			return nullptr;
+		}
+		addToCache(key, unwrap);
+		return unwrap;
+	}
+
 	void	FImageManager::ConvertPixels(const void *textureData, TArray<uint8> &outData, EPixelFormat pixelFormat, uint32 pixelCount)
 	{
 		switch (pixelFormat)
@@ -269,6 +584,45 @@ namespace RPR
 		cache.ReleaseAll();
 	}
 
+	/*
+	* Skips the mips above MaxTextureResolution, then the ones that wouldn't fit in what is left of TextureMemoryBudget.
+	* Images are bound to material nodes without the material owning them, so nothing loaded is evicted to make room:
+	* the budget only lowers the resolution of the textures loaded once it is reached.
+	* Counts the live images, RPR::DeleteObject untracks the ones dropped from the cache.
+	*/
+	int32	FImageManager::SelectFirstMip(const FTexturePlatformData* PlatformData, uint32 BytesPerPixel) const
+	{
+		const URPRSettings	*settings = GetDefault<URPRSettings>();
+		const int32			maxResolution = settings->MaxTextureResolution;
+		const int64			budget = int64(settings->TextureMemoryBudget) * 1024 * 1024;
+		const int64			residentBytes = budget > 0 ? RPR::Memory::GetTotal(RPR::Memory::ECategory::Image) : 0;
+
+		// Block compressed mips are decoded by 4x4 blocks
+		const EPixelFormat	pixelFormat = PlatformData->PixelFormat;
+		const bool	isBlockCompressed = pixelFormat == PF_DXT1 || pixelFormat == PF_DXT5 || pixelFormat == PF_BC5;
+		const int32	minSize = isBlockCompressed ? 4 : 1;
+
+		auto	canUseMip = [PlatformData, minSize](int32 mipIndex)
+		{
+			const FTexture2DMipMap	&mip = PlatformData->Mips[mipIndex];
+			return mip.SizeX >= minSize && mip.SizeY >= minSize && mip.BulkData.IsBulkDataLoaded();
+		};
+
+		int32	firstMip = 0;
+		const int32	mipCount = PlatformData->Mips.Num();
+		for (int32 iMip = 1; iMip < mipCount && canUseMip(iMip); ++iMip)
+		{
+			const FTexture2DMipMap	&mip = PlatformData->Mips[firstMip];
+			const int64	byteCount = int64(mip.SizeX) * mip.SizeY * BytesPerPixel;
+			const bool	isTooLarge = maxResolution > 0 && FMath::Max(mip.SizeX, mip.SizeY) > maxResolution;
+			const bool	isOverBudget = budget > 0 && residentBytes + byteCount > budget;
+			if (!isTooLarge && !isOverBudget)
+				break;
+			firstMip = iMip;
+		}
+		return firstMip;
+	}
+
 	bool FImageManager::IsFormatSupported(EPixelFormat format)
 	{
 		switch (format)
@@ -20,6 +20,9 @@
 #include "RPRSettings.h"
 #include "RPRCoreErrorHelper.h"
 #include "RadeonProRender_Baikal.h"
+#include "Async/Async.h"
+#include "Misc/ScopeLock.h"
+#include "HAL/FileManager.h"
 #define RIF_STATIC_LIBRARY 0
 #include "RadeonImageFilters.h"
 
@@ -29,6 +32,41 @@ static void* ImageLibraryHandler;
 static void* OpenImageIOLibraryHandler;
 
 namespace {
+	/*
+	* Returns the path of LibName in Directory.
+	* Shared objects are often only installed with their version suffix (libFoo.so.1.2), the highest one is picked then.
+	*/
+	FString FindDynamicLibrary(const FString& Directory, const FString& LibName)
+	{
+		const FString libPath = FPaths::Combine(Directory, LibName);
+		if (FPaths::FileExists(libPath))
+			return libPath;
+
+	#if PLATFORM_LINUX
+		TArray<FString> versionedNames;
+		IFileManager::Get().FindFiles(versionedNames, *FPaths::Combine(Directory, LibName + TEXT(".*")), true, false);
+		if (versionedNames.Num() > 0)
+		{
+			versionedNames.Sort([](const FString& A, const FString& B)
+			{
+				// Compare the version numbers one by one so that 1.10 is above 1.9
+				TArray<FString> aParts, bParts;
+				A.ParseIntoArray(aParts, TEXT("."));
+				B.ParseIntoArray(bParts, TEXT("."));
+				for (int32 i = 0; i < aParts.Num() && i < bParts.Num(); ++i)
+				{
+					if (aParts[i] != bParts[i])
+						return aParts[i].IsNumeric() && bParts[i].IsNumeric() ? FCString::Atoi(*aParts[i]) < FCString::Atoi(*bParts[i]) : aParts[i] < bParts[i];
+				}
+				return aParts.Num() < bParts.Num();
+			});
+			return FPaths::Combine(Directory, versionedNames.Last());
+		}
+	#endif
+
+		return libPath;
+	}
+
 	void ContextSetUint(RPR::FContext context, uint32 parameter, uint32 value, FString errMsg)
 	{
 		RPR::FResult result;
@@ -71,16 +109,19 @@ bool FRPRCoreSystemResources::Initialize()
 
 	RenderEngine = settings->CurrentRenderType;
 
-	if (!bIsInitialized)
+	if (bIsInitialized)
+		Shutdown();
+
+	// Only the plugin of the selected quality is registered, the other one waits until it is selected
+	if (!LoadRenderEngineLibrary())
 	{
-		if (!LoadLibraries())
-		{
-			RenderEngine = ERenderType::None;
-			return (false);
-		}
+		RenderEngine = ERenderType::None;
+		return (false);
 	}
-	else
-		Shutdown();
+
+	// Let the denoiser library load while the scene builds, the first denoise waits on it
+	if (settings->UseDenoiser)
+		RequestImageFilterLibrary();
 
 	if (!InitializeContextEnvirontment())
 	{
@@ -93,33 +134,96 @@ bool FRPRCoreSystemResources::Initialize()
 	return (bIsInitialized);
 }
 
-bool FRPRCoreSystemResources::LoadLibraries()
+bool FRPRCoreSystemResources::LoadRenderEngineLibrary()
 {
-	if (!LoadRprDLL(TEXT("Tahoe"), TahoePluginId))
+#if WITH_RPR_MOCK_BACKEND
+	// The mock backend replaces the renderer plugins, the image libraries aren't built with it
+	if (TahoePluginId == INDEX_NONE)
 	{
-		UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot load Tahoe dynamic library"));
-		return (false);
+		TahoePluginId = RPR::RegisterPlugin(TEXT("Tahoe"));
+		HybridPluginId = TahoePluginId;
 	}
-
-	if (!LoadRprDLL(TEXT("Hybrid"), HybridPluginId))
+	return (true);
+#else
+	if (RenderEngine == ERenderType::Hybrid)
 	{
-		UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot load Hybrid dynamic library"));
+		if (!LoadRprDLL(TEXT("Hybrid"), HybridPluginId))
+		{
+			UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot load Hybrid dynamic library"));
+			return (false);
+		}
+	}
+	else if (!LoadRprDLL(TEXT("Tahoe"), TahoePluginId))
+	{
+		UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot load Tahoe dynamic library"));
 		return (false);
 	}
 
-	if (!LoadImageFilterDLL())
+	return (true);
+#endif
+}
+
+TSharedFuture<bool> FRPRCoreSystemResources::RequestImageFilterLibrary()
+{
+	FScopeLock lock(&LibraryRequestsLock);
+
+	if (!ImageFilterLibrary.IsValid())
 	{
-		UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot load RadeonImageFilters dynamic library"));
-		return (false);
+	#if WITH_RPR_MOCK_BACKEND
+		// Not built with the mock backend, the denoiser is unavailable
+		TPromise<bool> loaded;
+		loaded.SetValue(false);
+		ImageFilterLibrary = loaded.GetFuture().Share();
+	#else
+		ImageFilterLibrary = Async(EAsyncExecution::ThreadPool, [this]()
+		{
+			const bool bLoaded = LoadImageFilterDLL();
+			if (!bLoaded)
+				UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot load RadeonImageFilters dynamic library"));
+			return bLoaded;
+		}).Share();
+	#endif
 	}
+	return ImageFilterLibrary;
+}
+
+TSharedFuture<bool> FRPRCoreSystemResources::RequestOpenImageIOLibrary()
+{
+	FScopeLock lock(&LibraryRequestsLock);
 
-	if (!LoadOpenImageIODLL())
+	if (!OpenImageIOLibrary.IsValid())
 	{
-		UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot load OpenImageIO dynamic library"));
-		return (false);
+	#if !WITH_RPR_LINKED_IMAGE_LIBRARIES
+		// Nothing to load, FImageSaver only uses OpenImageIO where it's linked
+		TPromise<bool> loaded;
+		loaded.SetValue(true);
+		OpenImageIOLibrary = loaded.GetFuture().Share();
+	#else
+		OpenImageIOLibrary = Async(EAsyncExecution::ThreadPool, [this]()
+		{
+			const bool bLoaded = LoadOpenImageIODLL();
+			if (!bLoaded)
+				UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot load OpenImageIO dynamic library"));
+			return bLoaded;
+		}).Share();
+	#endif
 	}
+	return OpenImageIOLibrary;
+}
 
-	return (true);
+void* FRPRCoreSystemResources::GetImageFilterExport(const TCHAR* Name) const
+{
+	return ImageLibraryHandler != nullptr ? FPlatformProcess::GetDllExport(ImageLibraryHandler, Name) : nullptr;
+}
+
+void FRPRCoreSystemResources::WaitForLibraryRequests()
+{
+	FScopeLock lock(&LibraryRequestsLock);
+
+	if (ImageFilterLibrary.IsValid())
+		ImageFilterLibrary.Wait();
+	if (OpenImageIOLibrary.IsValid())
+		OpenImageIOLibrary.Wait();
 }
 
 bool FRPRCoreSystemResources::InitializeContextEnvirontment()
@@ -151,14 +255,14 @@ bool FRPRCoreSystemResources::LoadRprDLL(const FString library, RPR::FPluginId &
 	#if PLATFORM_WINDOWS
 		const FString libName = library == TEXT("Hybrid") ? TEXT("Hybrid.dll") : TEXT("Tahoe64.dll");
 	#elif PLATFORM_LINUX
-		const FString libName = TEXT("Hybrid") ? TEXT("Hybrid.so") : TEXT("libTahoe64.so");
+		const FString libName = library == TEXT("Hybrid") ? TEXT("Hybrid.so") : TEXT("libTahoe64.so");
 	#else
 		UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Platform not supported"));
 		return (false);
 	#endif
 
 		const FString dllDirectory = FRPR_SDKModule::GetDLLsDirectory(TEXT("RadeonProRenderSDK"));
-		const FString dllPath = FPaths::Combine(dllDirectory, libName);
+		const FString dllPath = FindDynamicLibrary(dllDirectory, libName);
 
 		if (!FPaths::FileExists(dllPath))
 		{
@@ -191,7 +295,7 @@ bool FRPRCoreSystemResources::LoadImageFilterDLL()
 	#endif
 
 		const FString dllDirectory = FRPR_SDKModule::GetDLLsDirectory(TEXT("RadeonProImageProcessingSDK"));
-		const FString dllPath = FPaths::Combine(dllDirectory, imageFilters64LibName);
+		const FString dllPath = FindDynamicLibrary(dllDirectory, imageFilters64LibName);
 
 		if (!FPaths::FileExists(dllPath))
 		{
@@ -200,6 +304,11 @@ bool FRPRCoreSystemResources::LoadImageFilterDLL()
 		}
 
 		ImageLibraryHandler = FPlatformProcess::GetDllHandle(*dllPath);
+		if (ImageLibraryHandler == nullptr)
+		{
+			UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot open '%s'"), *dllPath);
+			return (false);
+		}
 	}
 	return (true);
 }
@@ -216,7 +325,7 @@ bool FRPRCoreSystemResources::LoadOpenImageIODLL()
 #endif
 
 		const FString dllDirectory = FRPR_SDKModule::GetDLLsDirectory(TEXT("OpenImageIO"));
-		const FString dllPath = FPaths::Combine(dllDirectory, oiioLibname);
+		const FString dllPath = FindDynamicLibrary(dllDirectory, oiioLibname);
 
 		if (!FPaths::FileExists(dllPath))
 		{
@@ -225,6 +334,11 @@ bool FRPRCoreSystemResources::LoadOpenImageIODLL()
 		}
 
 		OpenImageIOLibraryHandler = FPlatformProcess::GetDllHandle(*dllPath);
+		if (OpenImageIOLibraryHandler == nullptr)
+		{
+			UE_LOG(LogRPRCoreSystemResources, Error, TEXT("Cannot open '%s'"), *dllPath);
+			return (false);
+		}
 	}
 	return (true);
 }
@@ -425,6 +539,9 @@ void FRPRCoreSystemResources::Shutdown()
 {
 	NumDevicesCompatible = 0;
 
+	// The loader tasks capture this object
+	WaitForLibraryRequests();
+
 	DestroyRPRXMaterialLibrary();
 	DestroyRPRImageManager();
 	DestroyMaterialSystem();
@@ -89,14 +89,23 @@ namespace RPR
 		bool BuildRPRImageFormat(EPixelFormat srcFormat, FImageFormat &outFormat, uint32 &outComponentSize);
 		RPR::FImagePtr FindInCache(UTexture* Texture, bool bRebuild);
 		RPR::FImagePtr TryLoadErrorTexture();
+		int32 SelectFirstMip(const FTexturePlatformData* PlatformData, uint32 BytesPerPixel) const;
 
 		void ConvertPixels(const void *textureData, TArray<uint8> &outData, EPixelFormat pixelFormat, uint32 pixelCount);
 
+		struct FUnwrappedCubemap;
+		TSharedPtr<const FUnwrappedCubemap> FindOrUnwrapCubemap(UTextureCube* Texture);
+
 	private:
 
 		RPR::FContext context;
 		FImagesCache cache;
 
+		// Lat-long unwraps of the sky cubemaps, by source content and width.
+		// Kept across ClearCache so scene rebuilds don't unwrap them again.
+		TMap<FString, TSharedPtr<const FUnwrappedCubemap>> unwrappedCubemaps;
+		TArray<FString> unwrappedCubemapsOrder;
+
 	};
 
 	typedef TSharedPtr<FImageManager> FImageManagerPtr;
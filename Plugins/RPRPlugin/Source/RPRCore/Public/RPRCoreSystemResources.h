@@ -20,6 +20,8 @@
 #include "Material/RPRXMaterialLibrary.h"
 #include "ImageManager/RPRImageManager.h"
 #include "RprTools.h"
+#include "Async/Future.h"
+#include "HAL/CriticalSection.h"
 
 class RPRCORE_API FRPRCoreSystemResources
 {
@@ -33,6 +35,16 @@ public:
 	void	SetUESceneIsPlaying(const bool isPlaying);
 	bool	IsUEScenePlaying() const;
 
+	/*
+	* Libraries only needed by optional features are loaded on a pool thread the first time they are requested.
+	* Wait on the returned future before calling into the library.
+	*/
+	TSharedFuture<bool>	RequestImageFilterLibrary();
+	TSharedFuture<bool>	RequestOpenImageIOLibrary();
+
+	/* Address of an exported RadeonImageFilters function, nullptr until RequestImageFilterLibrary succeeded */
+	void*	GetImageFilterExport(const TCHAR* Name) const;
+
 public:
 
 	FORCEINLINE RPR::FContext			GetRPRContext() const { return RPRContext; }
@@ -46,7 +58,8 @@ public:
 
 private:
 
-	bool	LoadLibraries();
+	bool	LoadRenderEngineLibrary();
+	void	WaitForLibraryRequests();
 	bool	InitializeContextEnvirontment();
 	bool	InitializeContext();
 	bool	InitializeMaterialSystem();
@@ -84,6 +97,10 @@ private:
 	FRPRXMaterialLibrary	RPRXMaterialLibrary;
 
 	ERenderType             RenderEngine;
+
+	FCriticalSection		LibraryRequestsLock;
+	TSharedFuture<bool>		ImageFilterLibrary;
+	TSharedFuture<bool>		OpenImageIOLibrary;
 };
 
 typedef TSharedPtr<FRPRCoreSystemResources> FRPRCoreSystemResourcesPtr;
@@ -0,0 +1,423 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#include "Commandlets/RPRBenchmarkCommandlet.h"
+
+#include "RPRCoreModule.h"
+#include "RPRCoreSystemResources.h"
+#include "RPRMockBackend.h"
+#include "Scene/RPRActor.h"
+#include "Scene/RPRScene.h"
+#include "Scene/RPRStaticMeshComponent.h"
+#include "Helpers/ContextHelper.h"
+#include "Helpers/RPRHelpers.h"
+#include "Helpers/RPRApiStats.h"
+#include "Typedefs/RPRTypedefs.h"
+
+#include "Components/InstancedStaticMeshComponent.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/Texture2D.h"
+#include "HAL/PlatformTime.h"
+#include "Materials/MaterialInstanceConstant.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/UObjectIterator.h"
+
+#if WITH_EDITOR
+#	include "Editor.h"
+#	include "FileHelpers.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogRPRBenchmark, Log, All);
+
+namespace
+{
+	struct FStageResult
+	{
+		FString	Name;
+		double	Milliseconds;
+	};
+
+	struct FBenchmarkTimer
+	{
+		TArray<FStageResult>	&Results;
+		const TCHAR				*Stage;
+		double					StartTime;
+
+		FBenchmarkTimer(TArray<FStageResult> &results, const TCHAR *stage)
+			: Results(results)
+			, Stage(stage)
+			, StartTime(FPlatformTime::Seconds())
+		{}
+
+		~FBenchmarkTimer()
+		{
+			const double	milliseconds = (FPlatformTime::Seconds() - StartTime) * 1000.0;
+			UE_LOG(LogRPRBenchmark, Display, TEXT("%-24s %10.2f ms"), Stage, milliseconds);
+			Results.Add({ Stage, milliseconds });
+		}
+	};
+
+#if WITH_EDITOR
+	const TCHAR	*kBasicShapes[] =
+	{
+		TEXT("/Engine/BasicShapes/Cube.Cube"),
+		TEXT("/Engine/BasicShapes/Sphere.Sphere"),
+		TEXT("/Engine/BasicShapes/Cylinder.Cylinder"),
+		TEXT("/Engine/BasicShapes/Cone.Cone"),
+		TEXT("/Engine/BasicShapes/Plane.Plane"),
+	};
+
+	// Engine content only, so the benchmark runs in any project
+	bool	SpawnSyntheticScene(UWorld *world, int32 meshCount, int32 instanceCount, int32 materialCount, int32 textureCount, int32 textureSize,
+								TArray<AActor*> &outActors, TArray<UTexture2D*> &outTextures)
+	{
+		UMaterialInterface	*baseMaterial = LoadObject<UMaterialInterface>(nullptr, TEXT("/Engine/BasicShapes/BasicShapeMaterial.BasicShapeMaterial"));
+		TArray<UStaticMesh*>	meshes;
+		for (const TCHAR *path : kBasicShapes)
+		{
+			UStaticMesh	*mesh = LoadObject<UStaticMesh>(nullptr, path);
+			if (mesh != nullptr)
+				meshes.Add(mesh);
+		}
+		if (baseMaterial == nullptr || meshes.Num() == 0)
+			return false;
+
+		TArray<UMaterialInterface*>	materials;
+		for (int32 iMaterial = 0; iMaterial < materialCount; ++iMaterial)
+		{
+			UMaterialInstanceConstant	*material = NewObject<UMaterialInstanceConstant>(GetTransientPackage());
+			material->SetParentEditorOnly(baseMaterial);
+			material->SetVectorParameterValueEditorOnly(TEXT("Color"), FLinearColor::MakeFromHSV8((uint8)(iMaterial * 37), 200, 200));
+			materials.Add(material);
+		}
+
+		// Not referenced by the materials, they are loaded straight through the image manager
+		for (int32 iTexture = 0; iTexture < textureCount; ++iTexture)
+		{
+			UTexture2D	*texture = UTexture2D::CreateTransient(textureSize, textureSize, PF_B8G8R8A8);
+			if (texture == nullptr)
+				return false;
+			texture->AddToRoot();
+
+			FByteBulkData	&bulkData = texture->PlatformData->Mips[0].BulkData;
+			uint8			*pixels = static_cast<uint8*>(bulkData.Lock(LOCK_READ_WRITE));
+			const int32		byteCount = textureSize * textureSize * 4;
+			for (int32 i = 0; i < byteCount; ++i)
+				pixels[i] = (uint8)(i * 31 + iTexture);
+			bulkData.Unlock();
+			outTextures.Add(texture);
+		}
+
+		for (int32 iMesh = 0; iMesh < meshCount; ++iMesh)
+		{
+			AActor	*actor = world->SpawnActor<AActor>();
+			check(actor != nullptr);
+
+			UStaticMeshComponent	*component = instanceCount > 1 ? NewObject<UInstancedStaticMeshComponent>(actor) : NewObject<UStaticMeshComponent>(actor);
+			component->SetStaticMesh(meshes[iMesh % meshes.Num()]);
+			component->SetMaterial(0, materials[iMesh % materials.Num()]);
+			actor->SetRootComponent(component);
+			component->SetWorldLocation(FVector(iMesh % 32, iMesh / 32, 0.0f) * 150.0f);
+
+			UInstancedStaticMeshComponent	*instancedComponent = Cast<UInstancedStaticMeshComponent>(component);
+			for (int32 iInstance = 0; instancedComponent != nullptr && iInstance < instanceCount; ++iInstance)
+				instancedComponent->AddInstance(FTransform(FRotator(0.0f, iInstance * 7.0f, 0.0f), FVector(0.0f, 0.0f, iInstance * 120.0f)));
+
+			component->RegisterComponent();
+			outActors.Add(actor);
+		}
+		return true;
+	}
+
+	bool	WriteResults(const FString &filename, const FString &sceneName, int32 componentCount, int32 builtCount, int32 textureCount,
+						 int32 width, int32 height, int32 iterations, int32 errorCount, const TArray<FStageResult> &stages)
+	{
+		FString	json = TEXT("{\n");
+		json += FString::Printf(TEXT("\t\"scene\": \"%s\",\n"), *sceneName.ReplaceCharWithEscapedChar());
+		json += FString::Printf(TEXT("\t\"mockBackend\": %s,\n"), RPR::Mock::IsEnabled() ? TEXT("true") : TEXT("false"));
+		json += FString::Printf(TEXT("\t\"meshComponents\": %d,\n\t\"builtComponents\": %d,\n\t\"textures\": %d,\n"), componentCount, builtCount, textureCount);
+		json += FString::Printf(TEXT("\t\"width\": %d,\n\t\"height\": %d,\n\t\"iterations\": %d,\n\t\"errors\": %d,\n"), width, height, iterations, errorCount);
+
+		json += TEXT("\t\"stages\": [");
+		for (int32 iStage = 0; iStage < stages.Num(); ++iStage)
+		{
+			json += FString::Printf(TEXT("%s\n\t\t{ \"name\": \"%s\", \"ms\": %.3f }"),
+				iStage > 0 ? TEXT(",") : TEXT(""), *stages[iStage].Name, stages[iStage].Milliseconds);
+		}
+		json += TEXT("\n\t],\n");
+
+		TArray<RPR::ApiStats::FFunctionStats>	calls;
+		RPR::ApiStats::GetStats(calls);
+
+		json += TEXT("\t\"rprCalls\": [");
+		for (int32 iCall = 0; iCall < calls.Num(); ++iCall)
+		{
+			json += FString::Printf(TEXT("%s\n\t\t{ \"function\": \"%s\", \"calls\": %lld, \"ms\": %.3f, \"bytes\": %lld }"),
+				iCall > 0 ? TEXT(",") : TEXT(""), calls[iCall].Name, calls[iCall].Calls, calls[iCall].Seconds * 1000.0, calls[iCall].Bytes);
+		}
+		json += TEXT("\n\t]\n}\n");
+
+		return FFileHelper::SaveStringToFile(json, *filename);
+	}
+#endif
+}
+
+URPRBenchmarkCommandlet::URPRBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32	URPRBenchmarkCommandlet::Main(const FString &Params)
+{
+#if WITH_EDITOR
+	FString	mapName;
+	int32	meshCount = 64;
+	int32	instanceCount = 16;
+	int32	materialCount = 64;
+	int32	textureCount = 16;
+	int32	textureSize = 1024;
+	int32	width = 1920;
+	int32	height = 1080;
+	int32	iterations = 16;
+	FString	outputFilename = FPaths::Combine(FPaths::ProfilingDir(), TEXT("RPRBenchmark.json"));
+
+	const bool	hasMap = FParse::Value(*Params, TEXT("Map="), mapName);
+	FParse::Value(*Params, TEXT("Meshes="), meshCount);
+	FParse::Value(*Params, TEXT("Instances="), instanceCount);
+	FParse::Value(*Params, TEXT("Materials="), materialCount);
+	FParse::Value(*Params, TEXT("Textures="), textureCount);
+	FParse::Value(*Params, TEXT("TextureSize="), textureSize);
+	FParse::Value(*Params, TEXT("Width="), width);
+	FParse::Value(*Params, TEXT("Height="), height);
+	FParse::Value(*Params, TEXT("Iterations="), iterations);
+	FParse::Value(*Params, TEXT("Output="), outputFilename);
+
+	if (meshCount <= 0 || instanceCount < 0 || materialCount <= 0 ||
+		textureCount < 0 || textureSize <= 0 || width <= 0 || height <= 0 || iterations < 0)
+	{
+		UE_LOG(LogRPRBenchmark, Error, TEXT("Usage: -run=RPRBenchmark [-Map=<Map>] [-Meshes=N] [-Instances=N] [-Materials=N] [-Textures=N] [-TextureSize=N] [-Width=N] [-Height=N] [-Iterations=N] [-Output=<File.json>]"));
+		return 1;
+	}
+
+	if (!RPR::Mock::IsEnabled())
+		UE_LOG(LogRPRBenchmark, Warning, TEXT("Running against the real RPR backend, timings include the renderer"));
+
+	FRPRCoreSystemResourcesPtr	resources = IRPRCore::GetResources();
+	if (!resources.IsValid() || (!resources->IsInitialized() && !resources->Initialize()))
+	{
+		UE_LOG(LogRPRBenchmark, Error, TEXT("Couldn't initialize the RPR context"));
+		return 1;
+	}
+
+	if (hasMap && !FEditorFileUtils::LoadMap(mapName, false, false))
+	{
+		UE_LOG(LogRPRBenchmark, Error, TEXT("Couldn't load map '%s'"), *mapName);
+		return 1;
+	}
+
+	UWorld	*world = GEditor->GetEditorWorldContext().World();
+	check(world != nullptr);
+
+	TArray<AActor*>		syntheticActors;
+	TArray<UTexture2D*>	syntheticTextures;
+	if (!hasMap && !SpawnSyntheticScene(world, meshCount, instanceCount, materialCount, textureCount, textureSize, syntheticActors, syntheticTextures))
+	{
+		UE_LOG(LogRPRBenchmark, Error, TEXT("Couldn't load the engine basic shapes"));
+		return 1;
+	}
+
+	// Same sources as ARPRScene::BuildScene, their textures are the ones the material parser will request
+	TArray<UStaticMeshComponent*>	srcComponents;
+	TSet<UTexture2D*>				textures(syntheticTextures);
+	for (TObjectIterator<UStaticMeshComponent> it; it; ++it)
+	{
+		if (it->GetWorld() != world ||
+			it->IsPendingKill() ||
+			!it->HasBeenCreated() ||
+			it->GetStaticMesh() == nullptr)
+			continue;
+		srcComponents.Add(*it);
+
+		TArray<UTexture*>	usedTextures;
+		it->GetUsedTextures(usedTextures, EMaterialQualityLevel::High);
+		for (UTexture *texture : usedTextures)
+		{
+			UTexture2D	*texture2D = Cast<UTexture2D>(texture);
+			if (texture2D != nullptr)
+				textures.Add(texture2D);
+		}
+	}
+
+	UE_LOG(LogRPRBenchmark, Display, TEXT("%d mesh components, %d textures, %dx%d framebuffer, %d iterations"),
+		srcComponents.Num(), textures.Num(), width, height, iterations);
+
+	RPR::FContext	context = resources->GetRPRContext();
+	ARPRScene		*scene = world->SpawnActor<ARPRScene>();
+	check(scene != nullptr);
+	if (RPR::IsResultFailed(RPR::Context::CreateScene(context, scene->m_RprScene)))
+	{
+		UE_LOG(LogRPRBenchmark, Error, TEXT("Couldn't create the RPR scene"));
+		return 1;
+	}
+
+	// Created the way ARPRScene::QueueBuildRPRActor does, the scene never starts its renderer thread
+	TArray<URPRStaticMeshComponent*>	components;
+	for (UStaticMeshComponent *srcComponent : srcComponents)
+	{
+		ARPRActor	*actor = world->SpawnActor<ARPRActor>();
+		check(actor != nullptr);
+		actor->SrcComponent = srcComponent;
+
+		URPRStaticMeshComponent	*component = NewObject<URPRStaticMeshComponent>(actor);
+		component->SrcComponent = srcComponent;
+		component->Scene = scene;
+		actor->SetRootComponent(component);
+		actor->Component = component;
+		component->RegisterComponent();
+		components.Add(component);
+	}
+
+	RPR::FImageManagerPtr			imageManager = resources->GetRPRImageManager();
+	TArray<FStageResult>			stages;
+	TArray<URPRStaticMeshComponent*>	builtComponents;
+	int32							errorCount = 0;
+
+	RPR::ApiStats::Reset();
+
+	{
+		FBenchmarkTimer	timer(stages, TEXT("Image loading"));
+
+		for (UTexture2D *texture : textures)
+		{
+			if (!imageManager->LoadImageFromTexture(texture).IsValid())
+				++errorCount;
+		}
+	}
+
+	{
+		FBenchmarkTimer	timer(stages, TEXT("Mesh extraction"));
+
+		// Stripped or culled sources fail to build, as they do in the viewport
+		for (URPRStaticMeshComponent *component : components)
+		{
+			if (component->Build())
+				builtComponents.Add(component);
+		}
+	}
+
+	{
+		FBenchmarkTimer	timer(stages, TEXT("Material parsing"));
+
+		for (URPRStaticMeshComponent *component : builtComponents)
+		{
+			if (!component->PostBuild())
+				++errorCount;
+		}
+	}
+
+	{
+		FBenchmarkTimer	timer(stages, TEXT("Render and readback"));
+
+		rpr_framebuffer_format	fbFormat;
+		fbFormat.num_components = 4;
+		fbFormat.type = RPR_COMPONENT_TYPE_FLOAT32;
+
+		rpr_framebuffer_desc	fbDesc;
+		fbDesc.fb_width = width;
+		fbDesc.fb_height = height;
+
+		rpr_framebuffer		frameBuffer = nullptr;
+		rpr_framebuffer		resolvedFrameBuffer = nullptr;
+		if (RPR::IsResultFailed(rprContextCreateFrameBuffer(context, fbFormat, &fbDesc, &frameBuffer)) ||
+			RPR::IsResultFailed(rprContextCreateFrameBuffer(context, fbFormat, &fbDesc, &resolvedFrameBuffer)) ||
+			RPR::IsResultFailed(rprContextSetAOV(context, RPR_AOV_COLOR, frameBuffer)) ||
+			RPR::IsResultFailed(rprContextSetScene(context, scene->m_RprScene)))
+		{
+			++errorCount;
+		}
+		else
+		{
+			TArray<float>	srcData;
+			TArray<uint8>	dstData;
+			srcData.SetNumUninitialized(width * height * 4);
+			dstData.SetNumUninitialized(width * height * 4);
+
+			for (int32 iIteration = 0; iIteration < iterations; ++iIteration)
+			{
+				if (RPR::IsResultFailed(rprContextRender(context)) ||
+					RPR::IsResultFailed(rprContextResolveFrameBuffer(context, frameBuffer, resolvedFrameBuffer, false)) ||
+					RPR::IsResultFailed(rprFrameBufferGetInfo(resolvedFrameBuffer, RPR_FRAMEBUFFER_DATA, srcData.Num() * sizeof(float), srcData.GetData(), nullptr)))
+				{
+					++errorCount;
+					break;
+				}
+				for (int32 i = 0; i < srcData.Num(); ++i)
+					dstData[i] = FMath::Clamp(FMath::RoundToInt(srcData[i] * 255.0f), 0, 255);
+			}
+			rprContextSetAOV(context, RPR_AOV_COLOR, nullptr);
+			rprContextSetScene(context, nullptr);
+		}
+		if (resolvedFrameBuffer != nullptr)
+			rprObjectDelete(resolvedFrameBuffer);
+		if (frameBuffer != nullptr)
+			rprObjectDelete(frameBuffer);
+	}
+
+	{
+		FBenchmarkTimer	timer(stages, TEXT("Cleanup"));
+
+		for (URPRStaticMeshComponent *component : components)
+			component->ReleaseResources();
+		URPRStaticMeshComponent::ClearCache(scene->m_RprScene);
+		resources->GetRPRMaterialLibrary().ClearCache();
+		imageManager->ClearCache();
+	}
+
+	for (URPRStaticMeshComponent *component : components)
+		component->GetOwner()->Destroy();
+	RPR::DeleteObject(scene->m_RprScene);
+	scene->m_RprScene = nullptr;
+	scene->Destroy();
+	for (AActor *actor : syntheticActors)
+		actor->Destroy();
+	for (UTexture2D *texture : syntheticTextures)
+		texture->RemoveFromRoot();
+
+	RPR::ApiStats::Dump(TEXT("time"));
+
+	const FString	sceneName = hasMap ? mapName : FString::Printf(TEXT("Synthetic (%d meshes x %d instances, %d materials)"), meshCount, instanceCount, materialCount);
+	if (!WriteResults(outputFilename, sceneName, components.Num(), builtComponents.Num(), textures.Num(), width, height, iterations, errorCount, stages))
+	{
+		UE_LOG(LogRPRBenchmark, Error, TEXT("Couldn't write the results to '%s'"), *outputFilename);
+		return 1;
+	}
+	UE_LOG(LogRPRBenchmark, Display, TEXT("Results written to '%s'"), *outputFilename);
+
+	if (errorCount > 0)
+	{
+		UE_LOG(LogRPRBenchmark, Error, TEXT("%d benchmark steps failed"), errorCount);
+		return 1;
+	}
+	return 0;
+#else
+	UE_LOG(LogRPRBenchmark, Error, TEXT("RPRBenchmark requires an editor build"));
+	return 1;
+#endif
+}
@@ -0,0 +1,232 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#include "Commandlets/RPRRenderSequenceCommandlet.h"
+
+#include "Scene/RPRScene.h"
+#include "RPRPlugin.h"
+#include "RPRSettings.h"
+#include "Helpers/RPRHelpers.h"
+
+#include "EngineUtils.h"
+#include "Camera/CameraComponent.h"
+#include "HAL/PlatformFilemanager.h"
+#include "Misc/Paths.h"
+
+#if WITH_EDITOR
+#	include "Editor.h"
+#	include "FileHelpers.h"
+#endif
+
+DEFINE_LOG_CATEGORY_STATIC(LogRPRRenderSequence, Log, All);
+
+namespace
+{
+	AActor	*FindCameraActor(UWorld *world, const FString &cameraName)
+	{
+		for (TActorIterator<AActor> it(world); it; ++it)
+		{
+			if (it->GetName() == cameraName &&
+				it->FindComponentByClass<UCameraComponent>() != nullptr)
+				return *it;
+		}
+		return nullptr;
+	}
+
+	bool	ParseVector(const FString &str, FVector &outVector)
+	{
+		TArray<FString>	components;
+		if (str.ParseIntoArray(components, TEXT(","), true) != 3)
+			return false;
+		outVector.X = FCString::Atof(*components[0]);
+		outVector.Y = FCString::Atof(*components[1]);
+		outVector.Z = FCString::Atof(*components[2]);
+		return true;
+	}
+
+	// The commandlet overrides the render settings of the project, they are put back whatever the exit path
+	struct FScopedSettingsRestore
+	{
+		URPRSettings	*m_Settings;
+		uint32			m_SamplingMax;
+		uint32			m_MaximumRenderIterations;
+		float			m_NoiseThreshold;
+		bool			m_Sync;
+
+		FScopedSettingsRestore(URPRSettings *settings)
+			: m_Settings(settings)
+			, m_SamplingMax(settings->SamplingMax)
+			, m_MaximumRenderIterations(settings->MaximumRenderIterations)
+			, m_NoiseThreshold(settings->NoiseThreshold)
+			, m_Sync(settings->bSync != 0)
+		{
+		}
+
+		~FScopedSettingsRestore()
+		{
+			m_Settings->SamplingMax = m_SamplingMax;
+			m_Settings->MaximumRenderIterations = m_MaximumRenderIterations;
+			m_Settings->NoiseThreshold = m_NoiseThreshold;
+			m_Settings->bSync = m_Sync;
+		}
+	};
+}
+
+URPRRenderSequenceCommandlet::URPRRenderSequenceCommandlet()
+{
+	IsClient = false;
+	IsEditor = true;
+	IsServer = false;
+	LogToConsole = true;
+}
+
+int32	URPRRenderSequenceCommandlet::Main(const FString &Params)
+{
+#if WITH_EDITOR
+	FString	mapName;
+	FString	cameraName;
+	if (!FParse::Value(*Params, TEXT("Map="), mapName) ||
+		!FParse::Value(*Params, TEXT("Camera="), cameraName))
+	{
+		UE_LOG(LogRPRRenderSequence, Error, TEXT("Usage: -run=RPRRenderSequence -Map=<Map> -Camera=<CameraActor> [-Frames=N] [-Output=<Directory>] [-Prefix=Frame] [-Format=png] [-FrameRate=24] [-Iterations=N] [-NoiseThreshold=T] [-Turntable=Degrees] [-Pivot=X,Y,Z] [-Timeout=Seconds]"));
+		return 1;
+	}
+
+	int32	frameCount = 1;
+	float	frameRate = 24.0f;
+	float	turntableDegrees = 0.0f;
+	float	timeoutSeconds = 600.0f;
+	FString	outputDirectory = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("ProRender"));
+	FString	prefix = TEXT("Frame");
+	FString	format = TEXT("png");
+	FString	pivotString;
+	FVector	pivot = FVector::ZeroVector;
+
+	FParse::Value(*Params, TEXT("Frames="), frameCount);
+	FParse::Value(*Params, TEXT("FrameRate="), frameRate);
+	FParse::Value(*Params, TEXT("Turntable="), turntableDegrees);
+	FParse::Value(*Params, TEXT("Timeout="), timeoutSeconds);
+	FParse::Value(*Params, TEXT("Output="), outputDirectory);
+	FParse::Value(*Params, TEXT("Prefix="), prefix);
+	FParse::Value(*Params, TEXT("Format="), format);
+	if (FParse::Value(*Params, TEXT("Pivot="), pivotString) && !ParseVector(pivotString, pivot))
+	{
+		UE_LOG(LogRPRRenderSequence, Error, TEXT("Invalid pivot '%s', expected X,Y,Z"), *pivotString);
+		return 1;
+	}
+	if (frameCount <= 0 || frameRate <= 0.0f)
+	{
+		UE_LOG(LogRPRRenderSequence, Error, TEXT("Frames and FrameRate must be positive"));
+		return 1;
+	}
+
+	URPRSettings	*settings = RPR::GetSettings();
+	check(settings != nullptr);
+	FScopedSettingsRestore	settingsRestore(settings);
+
+	int32	iterations = 0;
+	if (FParse::Value(*Params, TEXT("Iterations="), iterations) && iterations > 0)
+	{
+		settings->SamplingMax = iterations;
+		settings->MaximumRenderIterations = iterations;
+	}
+	float	noiseThreshold = 0.0f;
+	const bool	hasNoiseThreshold = FParse::Value(*Params, TEXT("NoiseThreshold="), noiseThreshold);
+	if (hasNoiseThreshold)
+		settings->NoiseThreshold = noiseThreshold;
+
+	// Changes between frames are detected by the RPR components when the world ticks
+	settings->bSync = true;
+
+	if (!FPaths::DirectoryExists(outputDirectory) &&
+		!FPlatformFileManager::Get().GetPlatformFile().CreateDirectoryTree(*outputDirectory))
+	{
+		UE_LOG(LogRPRRenderSequence, Error, TEXT("Couldn't create output directory '%s'"), *outputDirectory);
+		return 1;
+	}
+
+	if (!FEditorFileUtils::LoadMap(mapName, false, false))
+	{
+		UE_LOG(LogRPRRenderSequence, Error, TEXT("Couldn't load map '%s'"), *mapName);
+		return 1;
+	}
+
+	UWorld	*world = GEditor->GetEditorWorldContext().World();
+	check(world != nullptr);
+
+	AActor	*camera = FindCameraActor(world, cameraName);
+	if (camera == nullptr)
+	{
+		UE_LOG(LogRPRRenderSequence, Error, TEXT("Couldn't find camera actor '%s' in '%s'"), *cameraName, *mapName);
+		return 1;
+	}
+
+	FRPRPluginModule	&plugin = FRPRPluginModule::Get();
+	plugin.CreateNewSceneFromCurrentOpenedWorldIFN();
+
+	ARPRScene	*scene = plugin.GetCurrentScene();
+	if (scene == nullptr)
+	{
+		UE_LOG(LogRPRRenderSequence, Error, TEXT("Couldn't create the RPR scene"));
+		return 1;
+	}
+
+	plugin.m_ActiveCameraName = cameraName;
+	plugin.m_RPRPaused = false;
+	scene->OnRender(plugin.m_ObjectsToBuild);
+	if (!scene->IsRPRSceneValid())
+	{
+		UE_LOG(LogRPRRenderSequence, Error, TEXT("Couldn't initialize RPR rendering"));
+		return 1;
+	}
+	if (hasNoiseThreshold)
+		scene->SetSamplingNoiseThreshold();
+
+	const FVector	pivotToCamera = camera->GetActorLocation() - pivot;
+	const float		deltaTime = 1.0f / frameRate;
+	int32			failedFrames = 0;
+
+	for (int32 iFrame = 0; iFrame < frameCount; ++iFrame)
+	{
+		if (turntableDegrees != 0.0f)
+		{
+			const float		angle = turntableDegrees * iFrame / frameCount;
+			const FVector	location = pivot + pivotToCamera.RotateAngleAxis(angle, FVector::UpVector);
+			camera->SetActorLocationAndRotation(location, (pivot - location).Rotation());
+		}
+
+		// Advance the world: animated actors move and the RPR components flag what changed
+		world->Tick(LEVELTICK_All, iFrame == 0 ? 0.0f : deltaTime);
+
+		const FString	filename = FPaths::Combine(outputDirectory, FString::Printf(TEXT("%s.%04d.%s"), *prefix, iFrame, *format));
+		if (!scene->RenderOfflineFrame(filename, timeoutSeconds))
+		{
+			UE_LOG(LogRPRRenderSequence, Error, TEXT("Frame %d/%d failed"), iFrame + 1, frameCount);
+			++failedFrames;
+			continue;
+		}
+		UE_LOG(LogRPRRenderSequence, Display, TEXT("Frame %d/%d done"), iFrame + 1, frameCount);
+	}
+
+	scene->OnPause();
+	plugin.m_RPRPaused = true;
+
+	return failedFrames > 0 ? 1 : 0;
+#else
+	UE_LOG(LogRPRRenderSequence, Error, TEXT("RPRRenderSequence requires an editor build"));
+	return 1;
+#endif
+}
@@ -19,11 +19,13 @@
 #include "RadeonProRender_CL.h"
 #include "RadeonImageFilters_cl.h"
 #include "RadeonImageFilters_gl.h"
+#include "ImageFilter/ImageFilterLibrary.h"
 
 #include "Async/Async.h"
 #include "Async/Future.h"
 #include "Async/AsyncWork.h"
 #include "Logging/LogMacros.h"
+#include "Helpers/RPRMemoryReport.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogImageFilter, Log, All);
 
@@ -38,6 +40,28 @@ DEFINE_LOG_CATEGORY_STATIC(LogImageFilter, Log, All);
 		UE_LOG(LogImageFilter, Error, msg); \
 	}
 
+namespace
+{
+	// Images created from framebuffer memory are not counted, they alias the RPR framebuffers
+	rif_int CreateTrackedRifImage(rif_context context, const rif_image_desc* desc, const TCHAR* source, rif_image* rifImage)
+	{
+		rif_int rifStatus = rifContextCreateImage(context, desc, nullptr, rifImage);
+		if (rifStatus == RIF_SUCCESS)
+		{
+			const int64 componentSize = desc->type == RIF_COMPONENT_TYPE_FLOAT32 ? 4 : desc->type == RIF_COMPONENT_TYPE_FLOAT16 ? 2 : 1;
+			RPR::Memory::Track(*rifImage, RPR::Memory::ECategory::Denoiser,
+				(int64)desc->image_width * desc->image_height * desc->num_components * componentSize, source);
+		}
+		return rifStatus;
+	}
+
+	rif_int DeleteTrackedRifImage(rif_image rifImage)
+	{
+		RPR::Memory::Untrack(rifImage);
+		return rifObjectDelete(rifImage);
+	}
+}
+
 static bool HasGpuContext(rpr_creation_flags contextFlags)
 {
 #define GPU(x) RPR_CREATION_FLAGS_ENABLE_GPU##x
@@ -117,6 +141,10 @@ int ImageFilter::CreateFilter(RifFilterType rifFilteType, bool useOpenImageDenoi
 {
 	int status;
 
+	// The ML models of RIF need a GPU, OpenImageDenoise runs the same inputs on the CPU
+	if (mRifContext->ContextType() == RifContextType::RifContextCPU)
+		useOpenImageDenoise = true;
+
 	switch (rifFilteType)
 	{
 	case RifFilterType::BilateralDenoise:
@@ -193,7 +221,7 @@ int ImageFilter::AddInput(RifFilterInput inputId, float* memPtr, size_t size, fl
 
 	rif_image rifImage = nullptr;
 
-	rif_int rifStatus = rifContextCreateImage(mRifContext->Context(), &desc, nullptr, &rifImage);
+	rif_int rifStatus = CreateTrackedRifImage(mRifContext->Context(), &desc, TEXT("Denoiser input"), &rifImage);
 	CHECK_ERROR(rifStatus, TEXT("RPR denoiser failed to create RIF image"));
 
 	rifStatus = mRifFilter->AddInput(inputId, rifImage, memPtr, size, sigma);
@@ -264,7 +292,7 @@ RifContextWrapper::~RifContextWrapper()
 
 	if (mOutputRifImage != nullptr)
 	{
-		rifStatus = rifObjectDelete(mOutputRifImage);
+		rifStatus = DeleteTrackedRifImage(mOutputRifImage);
 		LOG_ERROR(rifStatus, TEXT("Can't delete rif object mOutputRifImage"));
 	}
 
@@ -303,7 +331,7 @@ const RifContextType RifContextWrapper::ContextType() const
 
 int RifContextWrapper::CreateOutput(const rif_image_desc& desc)
 {
-	rif_int rifStatus = rifContextCreateImage(mRifContextHandle, &desc, nullptr, &mOutputRifImage);
+	rif_int rifStatus = CreateTrackedRifImage(mRifContextHandle, &desc, TEXT("Denoiser output"), &mOutputRifImage);
 	CHECK_ERROR(rifStatus, TEXT("RPR denoiser failed to create output image"));
 
 	return RIF_SUCCESS;
@@ -421,7 +449,7 @@ int RifContextCPU::Initialize(rpr_context rprContext)
 
 int RifContextCPU::CreateRifImage(const rpr_framebuffer rprFrameBuffer, const rif_image_desc& desc, rif_image* rifImage)
 {
-	rif_int rifStatus = rifContextCreateImage(mRifContextHandle, &desc, nullptr, rifImage);
+	rif_int rifStatus = CreateTrackedRifImage(mRifContextHandle, &desc, TEXT("Denoiser input"), rifImage);
 	CHECK_ERROR(rifStatus, TEXT("RPR denoiser failed to create RIF image"));
 
 	return RIF_SUCCESS;
@@ -487,7 +515,7 @@ RifInput::RifInput(rif_image rifImage, float sigma) :
 
 RifInput::~RifInput()
 {
-	rifObjectDelete(mRifImage);
+	DeleteTrackedRifImage(mRifImage);
 }
 
 RifInputGPU::RifInputGPU(rif_image rifImage, float sigma) :
@@ -573,7 +601,7 @@ RifFilterWrapper::~RifFilterWrapper()
 
 	for (const rif_image& auxImage : mAuxImages)
 	{
-		rifObjectDelete(auxImage);
+		DeleteTrackedRifImage(auxImage);
 	}
 
 	for (const rif_image_filter& auxFilter : mAuxFilters)
@@ -722,7 +750,7 @@ int RifFilterLwr::Initialize(const RifContextWrapper* rifContext, uint32 width,
 
 	for (rif_image& auxImage : mAuxImages)
 	{
-		rifStatus = rifContextCreateImage(rifContext->Context(), &desc, nullptr, &auxImage);
+		rifStatus = CreateTrackedRifImage(rifContext->Context(), &desc, TEXT("Denoiser LWR auxiliary"), &auxImage);
 		CHECK_ERROR(rifStatus, TEXT("RPR denoiser failed to create auxillary image"));
 	}
 
@@ -812,10 +840,10 @@ int RifFilterEaw::Initialize(const RifContextWrapper* rifContext, uint32 width,
 
 	mAuxImages.SetNumZeroed(AuxImageMax);
 
-	rifStatus = rifContextCreateImage(rifContext->Context(), &desc, nullptr, &mAuxImages[ColorVarianceImage]);
+	rifStatus = CreateTrackedRifImage(rifContext->Context(), &desc, TEXT("Denoiser EAW auxiliary"), &mAuxImages[ColorVarianceImage]);
 	CHECK_ERROR(rifStatus, TEXT("RPR denoiser failed to create auxillary image"));
 
-	rifStatus = rifContextCreateImage(rifContext->Context(), &desc, nullptr, &mAuxImages[DenoisedOutputImage]);
+	rifStatus = CreateTrackedRifImage(rifContext->Context(), &desc, TEXT("Denoiser EAW auxiliary"), &mAuxImages[DenoisedOutputImage]);
 	CHECK_ERROR(rifStatus, TEXT("RPR denoiser failed to create auxillary image."));
 
 	return RIF_SUCCESS;
@@ -897,7 +925,7 @@ int RifFilterMl::Initialize(const RifContextWrapper* rifContext, uint32 width, u
 	// temporary output for ML denoiser with 3 components per pixel (by design of the filter)
 	rif_image_desc desc = {width, height, 0, 0, 0, 3, RIF_COMPONENT_TYPE_FLOAT32};
 
-	rifStatus = rifContextCreateImage(rifContext->Context(), &desc, nullptr, &mAuxImages[MlOutputRifImage]);
+	rifStatus = CreateTrackedRifImage(rifContext->Context(), &desc, TEXT("Denoiser ML output"), &mAuxImages[MlOutputRifImage]);
 	CHECK_ERROR(rifStatus, TEXT("RPR denoiser failed to create output image"));
 
 	// Normals remap filter setup
@@ -1001,7 +1029,7 @@ int RifFilterMlColorOnly::Initialize(const RifContextWrapper* rifContext, uint32
 	// temporary output for ML denoiser with 3 components per pixel (by design of the filter)
 	rif_image_desc desc = {width, height, 0, 0, 0, 3, RIF_COMPONENT_TYPE_FLOAT32};
 
-	rifStatus = rifContextCreateImage(rifContext->Context(), &desc, nullptr, &mAuxImages[MlOutputRifImage]);
+	rifStatus = CreateTrackedRifImage(rifContext->Context(), &desc, TEXT("Denoiser ML output"), &mAuxImages[MlOutputRifImage]);
 	CHECK_ERROR(rifStatus, TEXT("RPR denoiser failed to create output image"));
 
 	mAuxFilters.SetNumZeroed(AuxFilterMax);
@@ -0,0 +1,76 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#pragma once
+
+#include "RadeonImageFilters.h"
+#include "RadeonImageFilters_cl.h"
+#include "RPRCoreModule.h"
+#include "RPRCoreSystemResources.h"
+
+/*
+* Where RadeonImageFilters isn't linked (see RPR_SDK.Build.cs), the rif functions used by ImageFilter.cpp are resolved
+* in the library opened by FRPRCoreSystemResources::RequestImageFilterLibrary, the way delay-loading does it on Windows.
+* Only include it from ImageFilter.cpp: the function names are redefined, every rif function it calls must be listed below.
+*/
+#if !WITH_RPR_LINKED_IMAGE_LIBRARIES
+
+namespace RPR
+{
+	namespace ImageFilterLibrary
+	{
+		// The handful of calls per denoise don't justify caching the addresses across library reloads
+		template<typename TFunction, typename... TArgs>
+		rif_int	Call(const TCHAR* Name, TArgs&&... Args)
+		{
+			TFunction function = (TFunction) IRPRCore::GetResources()->GetImageFilterExport(Name);
+			if (function == nullptr)
+				return RIF_ERROR_UNSUPPORTED;
+			return function(Forward<TArgs>(Args)...);
+		}
+	}
+}
+
+// decltype doesn't reference the symbol, nothing is left for the linker to resolve
+#define RPR_RIF_DYNAMIC_CALL(Function, ...)	RPR::ImageFilterLibrary::Call<decltype(&::Function)>(TEXT(#Function), __VA_ARGS__)
+
+#define rifGetDeviceCount(...)							RPR_RIF_DYNAMIC_CALL(rifGetDeviceCount, __VA_ARGS__)
+#define rifCreateContext(...)							RPR_RIF_DYNAMIC_CALL(rifCreateContext, __VA_ARGS__)
+#define rifCreateContextFromOpenClContext(...)			RPR_RIF_DYNAMIC_CALL(rifCreateContextFromOpenClContext, __VA_ARGS__)
+#define rifContextCreateCommandQueue(...)				RPR_RIF_DYNAMIC_CALL(rifContextCreateCommandQueue, __VA_ARGS__)
+#define rifContextCreateImage(...)						RPR_RIF_DYNAMIC_CALL(rifContextCreateImage, __VA_ARGS__)
+#define rifContextCreateImageFromOpenClMemory(...)		RPR_RIF_DYNAMIC_CALL(rifContextCreateImageFromOpenClMemory, __VA_ARGS__)
+#define rifContextCreateImageFilter(...)				RPR_RIF_DYNAMIC_CALL(rifContextCreateImageFilter, __VA_ARGS__)
+#define rifContextExecuteCommandQueue(...)				RPR_RIF_DYNAMIC_CALL(rifContextExecuteCommandQueue, __VA_ARGS__)
+#define rifCommandQueueAttachImageFilter(...)			RPR_RIF_DYNAMIC_CALL(rifCommandQueueAttachImageFilter, __VA_ARGS__)
+#define rifCommandQueueDetachImageFilter(...)			RPR_RIF_DYNAMIC_CALL(rifCommandQueueDetachImageFilter, __VA_ARGS__)
+#define rifImageFilterSetParameter1f(...)				RPR_RIF_DYNAMIC_CALL(rifImageFilterSetParameter1f, __VA_ARGS__)
+#define rifImageFilterSetParameter1u(...)				RPR_RIF_DYNAMIC_CALL(rifImageFilterSetParameter1u, __VA_ARGS__)
+#define rifImageFilterSetParameter2u(...)				RPR_RIF_DYNAMIC_CALL(rifImageFilterSetParameter2u, __VA_ARGS__)
+#define rifImageFilterSetParameterImage(...)			RPR_RIF_DYNAMIC_CALL(rifImageFilterSetParameterImage, __VA_ARGS__)
+#define rifImageFilterSetParameterImageArray(...)		RPR_RIF_DYNAMIC_CALL(rifImageFilterSetParameterImageArray, __VA_ARGS__)
+#define rifImageFilterSetParameterFloatArray(...)		RPR_RIF_DYNAMIC_CALL(rifImageFilterSetParameterFloatArray, __VA_ARGS__)
+#define rifImageFilterSetParameterString(...)			RPR_RIF_DYNAMIC_CALL(rifImageFilterSetParameterString, __VA_ARGS__)
+#define rifImageGetInfo(...)							RPR_RIF_DYNAMIC_CALL(rifImageGetInfo, __VA_ARGS__)
+#define rifImageMap(...)								RPR_RIF_DYNAMIC_CALL(rifImageMap, __VA_ARGS__)
+#define rifImageUnmap(...)								RPR_RIF_DYNAMIC_CALL(rifImageUnmap, __VA_ARGS__)
+#define rifObjectDelete(...)							RPR_RIF_DYNAMIC_CALL(rifObjectDelete, __VA_ARGS__)
+
+#if defined(__APPLE__)
+#define rifContextCreateImageFromMetalMemory(...)		RPR_RIF_DYNAMIC_CALL(rifContextCreateImageFromMetalMemory, __VA_ARGS__)
+#endif
+
+#endif // !WITH_RPR_LINKED_IMAGE_LIBRARIES
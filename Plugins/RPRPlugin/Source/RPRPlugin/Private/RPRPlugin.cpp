@@ -70,6 +70,7 @@ FRPRPluginModule::FRPRPluginModule()
 ,	m_OrbitEnabled(false)
 ,	m_Loaded(false)
 ,	m_AOVMode(RPR::EAOV::Color)
+,	m_RegionOfInterest(ForceInit)
 {
 }
 
@@ -456,6 +457,15 @@ RPR::EAOV FRPRPluginModule::GetAOV() const
 	return m_AOVMode;
 }
 
+void	FRPRPluginModule::SetRegionOfInterest(const FBox2D &region)
+{
+	m_RegionOfInterest = region;
+
+	ARPRScene	*scene = GetCurrentScene();
+	if (scene != nullptr)
+		scene->UpdateRegionOfInterest();
+}
+
 void	FRPRPluginModule::StartupModule()
 {
 	UE_LOG(LogRPRPlugin, VeryVerbose, TEXT("Startup RPR Plugin module..."));
@@ -18,6 +18,8 @@
 #include <Misc/ScopeLock.h>
 #include "RprLoadStore.h"
 #include "HAL/RunnableThread.h"
+#include "HAL/Event.h"
+#include "HAL/IConsoleManager.h"
 
 #include "Misc/Paths.h"
 
@@ -29,12 +31,18 @@
 #include "Helpers/RPRHelpers.h"
 #include "Helpers/RPRErrorsHelpers.h"
 #include "Helpers/ContextHelper.h"
+#include "Helpers/RPRTrace.h"
+#include "Helpers/RPRScratchMemory.h"
+#include "Helpers/RPRSceneStandardizer.h"
 #include <RPRCoreModule.h>
 
 #include "RPR_SDKModule.h"
 #include "RadeonProRender_Baikal.h"
 
 #include "Tools/FImageSaver.h"
+#include "RPRCoreSystemResources.h"
+#include "ProRenderGLTF.h"
+#include "Async/Async.h"
 
 
 DEFINE_STAT(STAT_ProRender_PreRender);
@@ -42,9 +50,28 @@ DEFINE_STAT(STAT_ProRender_RebuildScene);
 DEFINE_STAT(STAT_ProRender_Render);
 DEFINE_STAT(STAT_ProRender_Resolve);
 DEFINE_STAT(STAT_ProRender_Readback);
+DEFINE_STAT(STAT_ProRender_BuildScratchHighWater);
 
 DEFINE_LOG_CATEGORY_STATIC(LogRPRRenderer, Log, All);
 
+static TAutoConsoleVariable<float> CVarRPRIdlePollInterval(
+	TEXT("RPR.Renderer.IdlePollInterval"),
+	1.0f,
+	TEXT("Seconds the RPR thread waits between checks when paused or converged, unless woken up earlier.\n")
+	TEXT("Only needed to pick up RPR settings edited directly in the project settings. 0 waits for an explicit wake up."));
+
+static TAutoConsoleVariable<float> CVarRPRMotionResolutionScale(
+	TEXT("RPR.Viewport.MotionResolutionScale"),
+	0.5f,
+	TEXT("Resolution scale of the RPR viewport while the camera moves, upscaled for display. 1 disables.\n")
+	TEXT("Applied the next time the framebuffers are resized."));
+
+static TAutoConsoleVariable<int32> CVarRPRShowConvergence(
+	TEXT("RPR.AdaptiveSampling.ShowConvergence"),
+	0,
+	TEXT("Overlays a per tile convergence heat map on the RPR viewport while adaptive sampling is enabled.\n")
+	TEXT("Green tiles are under the noise threshold, yellow to red ones are still above it."));
+
 #define CHECK_ERROR(status, msg)  \
 	CA_CONSTANT_IF(status != 0) { \
 		UE_LOG(LogRPRRenderer, Error, msg); \
@@ -61,21 +88,37 @@ FRPRRendererWorker::FRPRRendererWorker(rpr_context context, rpr_scene rprScene,
 ,	m_CurrentIteration(0)
 ,	m_PreviousRenderedIteration(0)
 ,	m_NumDevices(numDevices)
+,	m_IterationsPerRender(1)
+,	m_SecondsPerIteration(0.0)
 ,	m_Width(width)
 ,	m_Height(height)
 ,	m_RprContext(context)
 ,	m_AOV(RPR::EAOV::Color)
 ,	m_RprScene(rprScene)
+,	m_PreviewWidth(0)
+,	m_PreviewHeight(0)
 ,	m_Resize(true)
 ,	m_IsBuildingObjects(false)
 ,	m_ClearFramebuffer(false)
 ,	m_PauseRender(true)
-,	m_CachedRaycastEpsilon(0.0f)
+,	m_RenderingFinished(false)
+,	m_PreviewRequested(false)
+,	m_PreviewActive(false)
+,	m_PrepareParked(false)
+,	m_LastActivePixelCount(0)
+,	m_LastConvergenceTime(0.0)
+,	m_ConvergenceRate(0.0)
+,	m_ConvergedRatio(0.0f)
+,	m_EstimatedSecondsLeft(-1.0f)
+,	m_Converged(false)
+,	m_ConvergenceDirty(false)
+,	m_VarianceDataValid(false)
 ,	m_Trace(false)
 ,	m_UpdateTrace(false)
 ,	m_TracePath("")
 {
 	m_Plugin = &FRPRPluginModule::Get();
+	m_WakeUpEvent = FPlatformProcess::GetSynchEventFromPool(false);
 	m_Thread = FRunnableThread::Create(this, TEXT("FRPRRendererWorker"));
 }
 
@@ -85,43 +128,104 @@ FRPRRendererWorker::~FRPRRendererWorker()
 
 	delete m_Thread;
 	m_Thread = nullptr;
+
+	FPlatformProcess::ReturnSynchEventToPool(m_WakeUpEvent);
+	m_WakeUpEvent = nullptr;
 }
 
 void	FRPRRendererWorker::SetTrace(bool trace, const FString &tracePath)
 {
-	m_PreRenderLock.Lock();
-	m_Trace = trace;
-	m_TracePath = tracePath;
-	m_UpdateTrace = true;
-	m_PreRenderLock.Unlock();
+	EnqueueCommand([this, trace, tracePath]()
+	{
+		m_Trace = trace;
+		m_TracePath = tracePath;
+		m_UpdateTrace = true;
+	});
 }
 
-int FRPRRendererWorker::SaveToFile(const FString& filename)
+void	FRPRRendererWorker::SaveToFile(const FString& filename)
 {
-	int status;
-	FString	extension;
+	if (filename.IsEmpty())
+		return;
 
-	extension = FPaths::GetExtension(filename);
-	if (filename.IsEmpty()) {
-		return RPR_ERROR_INVALID_PARAMETER;
-	}
+	EnqueueCommand([this, filename]()
+	{
+		int	status;
+		if (FPaths::GetExtension(filename) == TEXT("frs"))
+			status = SaveSceneToRPR(filename);
+		else
+			status = SaveFrameBuffer(filename);
+		if (status != RPR_SUCCESS)
+			UE_LOG(LogRPRRenderer, Error, TEXT("Couldn't save '%s' (%d)"), *filename, status);
+	});
+}
 
-	if (extension == TEXT("frs"))
+void	FRPRRendererWorker::ExportToGLTF(const FString &filename, TFunction<void(bool)> onCompleted)
+{
+	EnqueueCommand([this, filename, onCompleted]()
 	{
-		status = SaveSceneToRPR(filename);
-		CHECK_ERROR(status, TEXT("Save scene to rpr file failed"));
-	}
-	else
+		if (m_OnExportCompleted)
+		{
+			UE_LOG(LogRPRRenderer, Warning, TEXT("An export is already pending, ignoring '%s'"), *filename);
+			AsyncTask(ENamedThreads::GameThread, [onCompleted]() { onCompleted(false); });
+			return;
+		}
+		m_ExportPath = filename;
+		m_OnExportCompleted = onCompleted;
+	});
+}
+
+/*
+* Runs on the RPR thread, so the scene can't change under the exporter and the editor stays responsive.
+* Only the render lock is held: game thread calls that need it (AOV switch, immediate release) wait for the export.
+*/
+void	FRPRRendererWorker::ExportPendingScene()
+{
+	if (!m_OnExportCompleted)
+		return;
+	const FString			filename = m_ExportPath;
+	TFunction<void(bool)>	onCompleted = MoveTemp(m_OnExportCompleted);
+	m_OnExportCompleted = nullptr;
+	m_ExportPath.Empty();
+
+	bool	success = false;
 	{
-		status = SaveFrameBuffer(filename);
-		CHECK_ERROR(status, TEXT("Save framebuffer to file failed"));
+		FScopeLock	lock(&m_RenderLock);
+		RPR_TRACE_SCOPE_DETAIL("Export GLTF", *filename);
+
+		// The viewport scene is scaled for rendering, the exported one is in meters with one mesh per source mesh
+		rpr_scene		scene = nullptr;
+		RPR::FResult	status = RPR::FSceneStandardizer::CreateStandardizedScene(m_RprContext, m_RprScene, scene);
+		if (RPR::IsResultSuccess(status))
+		{
+			auto	resources = IRPRCore::GetResources();
+			status = rprExportToGLTF(TCHAR_TO_ANSI(*filename), m_RprContext, resources->GetMaterialSystem(), &scene, 1, 0);
+		}
+		success = RPR::IsResultSuccess(status);
+		if (!success)
+			UE_LOG(LogRPRRenderer, Error, TEXT("Couldn't export scene to '%s' (%d)"), *filename, status);
+
+		// Also puts the lights back in the viewport scene
+		if (scene != nullptr)
+			RPR::FSceneStandardizer::ReleaseStandardizedScene(scene);
 	}
 
-	return RPR_SUCCESS;
+	AsyncTask(ENamedThreads::GameThread, [onCompleted, success]()
+	{
+		onCompleted(success);
+	});
 }
 
 int FRPRRendererWorker::SaveDenoisedBuffer(const FString& fileName)
 {
+	RPR_TRACE_SCOPE_DETAIL("Save image", *fileName);
+
+	if (!IRPRCore::GetResources()->RequestOpenImageIOLibrary().Get())
+	{
+		UE_LOG(LogRPRRenderer, Error, TEXT("Couldn't save ProRender scene to '%s'. OpenImageIO Library is not available"), *fileName);
+		return RPR_ERROR_IO_ERROR;
+	}
+
 	FImageSaver is;
 	bool success;
 	success = is.WriteUint8ImageToFile(fileName, m_RenderData.GetData(), m_Width, m_Height);
@@ -135,12 +239,26 @@ int FRPRRendererWorker::SaveDenoisedBuffer(const FString& fileName)
 	return RPR_SUCCESS;
 }
 
+TFuture<bool>	FRPRRendererWorker::SaveRenderData(const FString& fileName)
+{
+	TSharedRef<TPromise<bool>, ESPMode::ThreadSafe>	promise = MakeShared<TPromise<bool>, ESPMode::ThreadSafe>();
+	TFuture<bool>									future = promise->GetFuture();
+
+	EnqueueCommand([this, fileName, promise]()
+	{
+		// m_RenderData holds the last readback, or the denoised image once the denoiser ran.
+		// Only this thread writes it, so it is read without m_DataLock
+		promise->SetValue(SaveDenoisedBuffer(fileName) == RPR_SUCCESS);
+	});
+	return future;
+}
+
+// Called from a queued command, on the RPR thread
 int FRPRRendererWorker::SaveFrameBuffer(const FString& fileName)
 {
 	int status;
 
-	// This will be blocking, should we rather queue this for the rendererworker to pick it up next iteration (if it is rendering) ?
-	FScopeLock lock(&m_RenderLock);
+	RPR_TRACE_SCOPE_DETAIL("Save framebuffer", *fileName);
 
 	if (RPR::GetSettings()->UseDenoiser)
 	{
@@ -158,12 +276,11 @@ int FRPRRendererWorker::SaveFrameBuffer(const FString& fileName)
 	return RPR_SUCCESS;
 }
 
+// Called from a queued command, on the RPR thread
 int  FRPRRendererWorker::SaveSceneToRPR(const FString& fileName)
 {
 	int status;
 
-	FScopeLock lock(&m_RenderLock);
-
 	unsigned int exportFlags = 0;
 	//exportFlags |= RPRLOADSTORE_EXPORTFLAG_EXTERNALFILES;
 	//exportFlags |= RPRLOADSTORE_EXPORTFLAG_COMPRESS_IMAGE_LEVEL_2;
@@ -174,19 +291,18 @@ int  FRPRRendererWorker::SaveSceneToRPR(const FString& fileName)
 	return RPR_SUCCESS;
 }
 
-bool	FRPRRendererWorker::ResizeFramebuffer(uint32 width, uint32 height)
+void	FRPRRendererWorker::ResizeFramebuffer(uint32 width, uint32 height)
 {
-	if (m_Width == width && m_Height == height)
-		return false;
-
-	m_PreRenderLock.Lock();
-	m_Width = width;
-	m_Height = height;
+	EnqueueCommand([this, width, height]()
+	{
+		if (m_Width == width && m_Height == height)
+			return;
 
-	m_Resize = true;
+		m_Width = width;
+		m_Height = height;
 
-	m_PreRenderLock.Unlock();
-	return true;
+		m_Resize = true;
+	});
 }
 
 bool	FRPRRendererWorker::RestartRender()
@@ -194,10 +310,11 @@ bool	FRPRRendererWorker::RestartRender()
 	if (m_RprFrameBuffer == nullptr ||
 		m_RprResolvedFrameBuffer == nullptr)
 		return false;
-	if (!m_PreRenderLock.TryLock())
-		return false;
-	m_ClearFramebuffer = true;
-	m_PreRenderLock.Unlock();
+	EnqueueCommand([this]()
+	{
+		m_ClearFramebuffer = true;
+		m_RenderingFinished = false;
+	});
 	return true;
 }
 
@@ -212,6 +329,9 @@ void	FRPRRendererWorker::SyncQueue(TArray<ARPRActor*> &newBuildQueue, TArray<ARP
 
 		// PostBuild
 
+		// Built or discarded objects pause the render until they are handed back here
+		const bool	releasesRender = m_BuiltObjects.Num() > 0 || m_DiscardObjects.Num() > 0 || m_PrepareParked;
+
 		// This is safe: RPR thread doesn't render if there are pending built objects
 		for (int32 iObject = 0; iObject < m_BuiltObjects.Num(); ++iObject)
 		{
@@ -245,10 +365,26 @@ void	FRPRRendererWorker::SyncQueue(TArray<ARPRActor*> &newBuildQueue, TArray<ARP
 		m_BuiltObjects.Empty();
 		m_IsBuildingObjects = m_BuildQueue.Num() > 0;
 
+		// Parked, the RPR thread neither updates nor renders: components can parse materials or load images for their next RPRThread_Update
+		if (m_PrepareParked)
+		{
+			m_PrepareRequested = false;
+			m_PrepareParked = false;
+			for (ARPRActor *actor : outBuiltObjects)
+			{
+				URPRSceneComponent	*comp = actor != nullptr ? Cast<URPRSceneComponent>(actor->GetRootComponent()) : nullptr;
+				if (comp != nullptr)
+					comp->PrepareUpdate();
+			}
+		}
+
 		if (m_IsBuildingObjects)
 			m_CurrentIteration = 0;
 
 		m_PreRenderLock.Unlock();
+
+		if (m_IsBuildingObjects || releasesRender)
+			WakeUp();
 		newBuildQueue.Empty();
 	}
 }
@@ -278,7 +414,7 @@ void	FRPRRendererWorker::SetQualitySettings(ERPRQualitySettings qualitySettings)
 	}
 	}
 
-	LockedContextSetParameterAndRestartRender1u(
+	QueueContextSetParameterAndRestartRender1u(
 		RPR_CONTEXT_RENDER_QUALITY,
 		hybridRenderQuality,
 		TEXT("Quality settings of Hybrid render"),
@@ -292,7 +428,7 @@ void FRPRRendererWorker::SetSamplingMinSPP()
 	if (settings->IsHybrid)
 		return;
 
-	LockedContextSetParameterAndRestartRender1u(
+	QueueContextSetParameterAndRestartRender1u(
 		RPR_CONTEXT_ADAPTIVE_SAMPLING_MIN_SPP,
 		settings->SamplingMin,
 		TEXT("Sampling Min"),
@@ -306,14 +442,14 @@ void FRPRRendererWorker::SetSamplingNoiseThreshold()
 	if (settings->IsHybrid)
 		return;
 
-	LockedContextSetParameterAndRestartRender1f(
+	QueueContextSetParameterAndRestartRender1f(
 		RPR_CONTEXT_ADAPTIVE_SAMPLING_THRESHOLD,
 		settings->NoiseThreshold,
 		TEXT("Sampling Noise Threshold"),
 		TEXT("ADAPTIVE_SAMPLING_THRESHOLD")
 	);
 
-	EnableAdaptiveSampling();
+	EnqueueCommand([this]() { EnableAdaptiveSampling(); });
 }
 
 int FRPRRendererWorker::SetDenoiserSettings(ERPRDenoiserOption denoiserOption)
@@ -356,22 +492,88 @@ int FRPRRendererWorker::SetDenoiserSettings(ERPRDenoiserOption denoiserOption)
 
 void	FRPRRendererWorker::SetPaused(bool pause)
 {
-	m_PreRenderLock.Lock();
-	m_PauseRender = pause;
-	m_PreRenderLock.Unlock();
+	EnqueueCommand([this, pause]() { m_PauseRender = pause; });
+}
+
+void	FRPRRendererWorker::SetInteractivePreview(bool preview)
+{
+	// Called every tick: only written here and read by UpdatePreviewBindings, the latest value wins
+	if (m_PreviewRequested == preview)
+		return;
+	m_PreviewRequested = preview;
+	WakeUp();
+}
+
+void	FRPRRendererWorker::SetRegionOfInterest(const FIntRect &region)
+{
+	EnqueueCommand([this, region]()
+	{
+		if (m_RegionOfInterest == region)
+			return;
+		m_RegionOfInterest = region;
+		m_ClearFramebuffer = true;
+		m_RenderingFinished = false;
+	});
+}
+
+FIntRect	FRPRRendererWorker::ConsumeDirtyRegion()
+{
+	const FIntRect	region = m_DirtyRegion;
+	m_DirtyRegion = FIntRect();
+	return region;
+}
+
+void	FRPRRendererWorker::WakeUp()
+{
+	if (m_WakeUpEvent != nullptr)
+		m_WakeUpEvent->Trigger();
+}
+
+void	FRPRRendererWorker::EnqueueCommand(TFunction<void()> &&command)
+{
+	// Counted before being visible to the RPR thread, see IsRenderingFinished
+	m_PendingCommands.Increment();
+	m_Commands.Enqueue(MoveTemp(command));
+	WakeUp();
+}
+
+uint32	FRPRRendererWorker::ExecuteCommands()
+{
+	uint32				commandCount = 0;
+	TFunction<void()>	command;
+	while (m_Commands.Dequeue(command))
+	{
+		command();
+		++commandCount;
+	}
+	return commandCount;
+}
+
+void	FRPRRendererWorker::RequestDenoise()
+{
+	EnqueueCommand([this]() { ApplyDenoiser(); });
+}
+
+void	FRPRRendererWorker::RequestPrepareUpdate()
+{
+	m_PrepareRequested = true;
+	WakeUp();
 }
 
 void	FRPRRendererWorker::SetAOV(RPR::EAOV AOV)
 {
-	if (m_AOV != AOV)
+	EnqueueCommand([this, AOV]()
 	{
+		if (m_AOV == AOV)
+			return;
+
 		FScopeLock sc(&m_RenderLock);
 
 		if (m_AOV == RPR::EAOV::Color)
 		{
 			// Replace the frame buffer of the color AOV because the color AOV is required to
 			// have to frame buffer linked to be able to render correctly
-			RPR::Context::SetAOV(m_RprContext, m_AOV, m_RprColorFrameBuffer);
+			RPR::Context::SetAOV(m_RprContext, m_AOV, m_PreviewActive ? m_RprPreviewColorFrameBuffer : m_RprColorFrameBuffer);
 		}
 		else
 		{
@@ -380,16 +582,20 @@ void	FRPRRendererWorker::SetAOV(RPR::EAOV AOV)
 		}
 
 		m_AOV = AOV;
-		RPR::Context::SetAOV(m_RprContext, m_AOV, m_RprFrameBuffer);
+		RPR::Context::SetAOV(m_RprContext, m_AOV, m_PreviewActive ? m_RprPreviewFrameBuffer : m_RprFrameBuffer);
 		m_ClearFramebuffer = true;
-	}
+	});
 }
 
 bool	FRPRRendererWorker::BuildFramebufferData()
 {
 	SCOPE_CYCLE_COUNTER(STAT_ProRender_Readback);
+	RPR_TRACE_SCOPE("Readback framebuffer");
 
-	RPR::FFrameBuffer& frameBuffer = RPR::GetSettings()->IsHybrid ? m_RprFrameBuffer : m_RprResolvedFrameBuffer;
+	const bool			preview = m_PreviewActive;
+	RPR::FFrameBuffer&	frameBuffer =
+		RPR::GetSettings()->IsHybrid ? m_RprFrameBuffer :
+		preview ? m_RprPreviewResolvedFrameBuffer : m_RprResolvedFrameBuffer;
 
 	size_t	totalByteCount = 0;
 	if (rprFrameBufferGetInfo(frameBuffer, RPR_FRAMEBUFFER_DATA, 0, nullptr, &totalByteCount) != RPR_SUCCESS)
@@ -397,9 +603,12 @@ bool	FRPRRendererWorker::BuildFramebufferData()
 		UE_LOG(LogRPRRenderer, Error, TEXT("Couldn't get framebuffer infos"));
 		return false;
 	}
-	if (m_SrcFramebufferData.Num() != totalByteCount / sizeof(float) ||
-		m_DstFramebufferData.Num() != totalByteCount ||
-		m_RenderData.Num() != totalByteCount)
+	const size_t	fullByteCount = (size_t)m_RprFrameBufferDesc.fb_width * m_RprFrameBufferDesc.fb_height * 16;
+	const size_t	expectedByteCount = preview ? (size_t)m_PreviewWidth * m_PreviewHeight * 16 : fullByteCount;
+	if (totalByteCount != expectedByteCount ||
+		m_SrcFramebufferData.Num() < totalByteCount / sizeof(float) ||
+		m_DstFramebufferData.Num() != fullByteCount ||
+		m_RenderData.Num() != fullByteCount)
 	{
 		UE_LOG(LogRPRRenderer, Error, TEXT("Invalid framebuffer size"));
 		return false;
@@ -414,22 +623,178 @@ bool	FRPRRendererWorker::BuildFramebufferData()
 	const float		*srcPixels = m_SrcFramebufferData.GetData();
 	const uint32	pixelCount = m_RprFrameBufferDesc.fb_width * m_RprFrameBufferDesc.fb_height;
 
-	check(pixelCount == totalByteCount / 16);
-	for (uint32 i = 0; i < pixelCount; ++i)
+	const FIntRect	fullRegion(0, 0, m_RprFrameBufferDesc.fb_width, m_RprFrameBufferDesc.fb_height);
+	const FIntRect	region = (!preview && m_ActiveRegion.Area() > 0) ? m_ActiveRegion : fullRegion;
+	if (!preview && region != fullRegion)
 	{
-		*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
-		*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
-		*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
-		*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
+		// Only the region of interest is sampled, the rest of m_RenderData keeps the last full render
+		for (int32 y = region.Min.Y; y < region.Max.Y; ++y)
+		{
+			const uint32	rowOffset = (y * fullRegion.Max.X + region.Min.X) * 4;
+			const float		*src = srcPixels + rowOffset;
+			uint8			*dst = dstPixels + rowOffset;
+			for (int32 i = 0; i < region.Width() * 4; ++i)
+				*dst++ = FMath::Clamp(*src++ * 255.0f, 0.0f, 255.0f);
+		}
 	}
+	else if (!preview)
+	{
+		check(pixelCount == totalByteCount / 16);
+		for (uint32 i = 0; i < pixelCount; ++i)
+		{
+			*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
+			*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
+			*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
+			*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
+		}
+	}
+	else
+	{
+		// Nearest upscale, the render texture keeps its full resolution
+		const uint32	dstWidth = m_RprFrameBufferDesc.fb_width;
+		const uint32	dstHeight = m_RprFrameBufferDesc.fb_height;
+		for (uint32 y = 0; y < dstHeight; ++y)
+		{
+			const float	*srcRow = srcPixels + (y * m_PreviewHeight / dstHeight) * m_PreviewWidth * 4;
+			for (uint32 x = 0; x < dstWidth; ++x)
+			{
+				const float	*src = srcRow + (x * m_PreviewWidth / dstWidth) * 4;
+				*dstPixels++ = FMath::Clamp(src[0] * 255.0f, 0.0f, 255.0f);
+				*dstPixels++ = FMath::Clamp(src[1] * 255.0f, 0.0f, 255.0f);
+				*dstPixels++ = FMath::Clamp(src[2] * 255.0f, 0.0f, 255.0f);
+				*dstPixels++ = FMath::Clamp(src[3] * 255.0f, 0.0f, 255.0f);
+			}
+		}
+	}
+	// The variance is read back before CommitRenderData takes m_DataLock
+	const bool	showConvergence =
+		!preview && CVarRPRShowConvergence.GetValueOnAnyThread() != 0 &&
+		!RPR::GetSettings()->IsHybrid && RPR::GetSettings()->EnableAdaptiveSampling &&
+		ReadVarianceData();
+
+	CommitRenderData(region, showConvergence);
+	return true;
+}
+
+bool	FRPRRendererWorker::ReadVarianceData()
+{
+	// RPR only reads whole framebuffers back, the heat map and the convergence check share one readback per render
+	if (m_VarianceDataValid)
+		return true;
+	m_VarianceData.SetNumUninitialized(m_RprFrameBufferDesc.fb_width * m_RprFrameBufferDesc.fb_height * 4, false);
+	m_VarianceDataValid = rprFrameBufferGetInfo(m_RprVarianceResolvedBuffer, RPR_FRAMEBUFFER_DATA, m_VarianceData.Num() * sizeof(float), m_VarianceData.GetData(), nullptr) == RPR_SUCCESS;
+	return m_VarianceDataValid;
+}
+
+/*
+* Debug view: tints each tile of m_HeatMapData by its mean variance, relative to the adaptive sampling threshold.
+* Gives an idea of where the remaining samples go, the renderer converges per pixel.
+* Only the viewport shows it, m_RenderData stays untouched for saves.
+*/
+void	FRPRRendererWorker::DrawConvergenceHeatMap(const FIntRect &region)
+{
+	static const int32	kTileSize = 16;
+
+	const uint32	width = m_RprFrameBufferDesc.fb_width;
+	const float		threshold = FMath::Max(RPR::GetSettings()->NoiseThreshold, SMALL_NUMBER);
+
+	uint8	*dstPixels = m_HeatMapData.GetData();
+	for (int32 tileY = region.Min.Y; tileY < region.Max.Y; tileY += kTileSize)
+	{
+		const int32	tileMaxY = FMath::Min(tileY + kTileSize, region.Max.Y);
+		for (int32 tileX = region.Min.X; tileX < region.Max.X; tileX += kTileSize)
+		{
+			const int32	tileMaxX = FMath::Min(tileX + kTileSize, region.Max.X);
+
+			double	variance = 0.0;
+			for (int32 y = tileY; y < tileMaxY; ++y)
+			{
+				const float	*src = m_VarianceData.GetData() + (y * width + tileX) * 4;
+				for (int32 x = tileX; x < tileMaxX; ++x, src += 4)
+					variance += (src[0] + src[1] + src[2]) / 3.0f;
+			}
+			variance /= (tileMaxX - tileX) * (tileMaxY - tileY);
+
+			// Yellow right above the threshold, red from ten times the threshold
+			const float	excess = FMath::Clamp((float)(variance / threshold - 1.0) / 9.0f, 0.0f, 1.0f);
+			const uint8	tint[3] =
+			{
+				uint8(variance <= threshold ? 0 : 255),
+				uint8(variance <= threshold ? 255 : 255 * (1.0f - excess)),
+				0
+			};
+
+			for (int32 y = tileY; y < tileMaxY; ++y)
+			{
+				uint8	*dst = dstPixels + (y * width + tileX) * 4;
+				for (int32 x = tileX; x < tileMaxX; ++x, dst += 4)
+				{
+					dst[0] = (dst[0] + tint[0]) / 2;
+					dst[1] = (dst[1] + tint[1]) / 2;
+					dst[2] = (dst[2] + tint[2]) / 2;
+				}
+			}
+		}
+	}
+}
+
+static void	CopyRegionRows(uint8 *dst, const uint8 *src, const FIntRect &region, uint32 width)
+{
+	const uint32	rowByteCount = region.Width() * 4;
+	if ((uint32)region.Width() == width)
+		FMemory::Memcpy(dst + region.Min.Y * width * 4, src + region.Min.Y * width * 4, rowByteCount * region.Height());
+	else
+	{
+		for (int32 y = region.Min.Y; y < region.Max.Y; ++y)
+		{
+			const uint32	rowOffset = (y * width + region.Min.X) * 4;
+			FMemory::Memcpy(dst + rowOffset, src + rowOffset, rowByteCount);
+		}
+	}
+}
+
+/*
+* Publishes the rows of region from m_DstFramebufferData to m_RenderData, read by the game thread.
+* With showConvergence, the viewport reads a tinted copy (m_HeatMapData) instead, m_VarianceData must be up to date.
+*/
+void	FRPRRendererWorker::CommitRenderData(const FIntRect &region, bool showConvergence)
+{
+	const uint32	width = m_RprFrameBufferDesc.fb_width;
+	FIntRect		dirtyRegion = region;
+
 	m_DataLock.Lock();
-	FMemory::Memcpy(m_RenderData.GetData(), m_DstFramebufferData.GetData(), m_DstFramebufferData.Num());
+	CopyRegionRows(m_RenderData.GetData(), m_DstFramebufferData.GetData(), region, width);
+	if (showConvergence)
+	{
+		if (m_HeatMapData.Num() != m_RenderData.Num())
+		{
+			// Just switched on or resized: outside of region, the viewport shows the untinted render
+			m_HeatMapData = m_RenderData;
+			dirtyRegion = FIntRect(0, 0, width, m_RprFrameBufferDesc.fb_height);
+		}
+		else
+			CopyRegionRows(m_HeatMapData.GetData(), m_RenderData.GetData(), region, width);
+		DrawConvergenceHeatMap(region);
+	}
+	else if (m_HeatMapData.Num() > 0)
+	{
+		// Tinted tiles outside of region must be replaced too
+		m_HeatMapData.Empty();
+		dirtyRegion = FIntRect(0, 0, width, m_RprFrameBufferDesc.fb_height);
+	}
+	if (m_DirtyRegion.Area() > 0)
+		m_DirtyRegion.Union(dirtyRegion);
+	else
+		m_DirtyRegion = dirtyRegion;
 	m_DataLock.Unlock();
-	return true;
 }
 
 void	FRPRRendererWorker::BuildQueuedObjects()
 {
+	// Build temporaries left on the RPR thread's stack are released with the batch
+	FMemMark		mark(FMemStack::Get());
+	RPR::ScratchMemory::ResetHighWaterMark();
+
 	const uint32	objectCount = m_BuildQueue.Num();
 	for (uint32 iObject = 0; iObject < objectCount; ++iObject)
 	{
@@ -442,6 +807,8 @@ void	FRPRRendererWorker::BuildQueuedObjects()
 		URPRSceneComponent	*component = Cast<URPRSceneComponent>(actor->GetRootComponent());
 		check(component != nullptr);
 
+		RPR_TRACE_SCOPE_DETAIL("Build object", *actor->GetName());
+
 		// Even if build fails, keep the component around to avoid having the async load
 		// adding each frame the previous components it failed to build before
 		if (component->Build())
@@ -450,6 +817,10 @@ void	FRPRRendererWorker::BuildQueuedObjects()
 			m_DiscardObjects.Add(actor);
 	}
 	m_BuildQueue.Empty();
+
+	const int64	highWaterMark = RPR::ScratchMemory::GetHighWaterMark();
+	SET_MEMORY_STAT(STAT_ProRender_BuildScratchHighWater, highWaterMark);
+	UE_LOG(LogRPRRenderer, Verbose, TEXT("Built %d objects, scratch memory peaked at %lld KB"), objectCount, highWaterMark / 1024);
 }
 
 int FRPRRendererWorker::ResizeFramebuffer()
@@ -471,6 +842,10 @@ int FRPRRendererWorker::ResizeFramebuffer()
 	DestroyFrameBuffer(&m_RprDiffuseAlbedoResolvedBuffer);
 	DestroyFrameBuffer(&m_RprVarianceBuffer);
 	DestroyFrameBuffer(&m_RprVarianceResolvedBuffer);
+	DestroyFrameBuffer(&m_RprPreviewFrameBuffer);
+	DestroyFrameBuffer(&m_RprPreviewResolvedFrameBuffer);
+	DestroyFrameBuffer(&m_RprPreviewColorFrameBuffer);
+	m_PreviewActive = false; // The full set is bound below
 
 	m_RprFrameBufferFormat.num_components = 4;
 	m_RprFrameBufferFormat.type = RPR_COMPONENT_TYPE_FLOAT32;
@@ -480,6 +855,9 @@ int FRPRRendererWorker::ResizeFramebuffer()
 	m_SrcFramebufferData.SetNum(m_Width * m_Height * 4);
 	m_DstFramebufferData.SetNum(m_Width * m_Height * 16);
 	m_RenderData.SetNum(m_DstFramebufferData.Num());
+	// Sized for the previous framebuffers, the next readback copies the render again
+	m_HeatMapData.Empty();
+	m_VarianceDataValid = false;
 
 	if (ContextCreateFrameBuffer(m_RprContext, m_RprFrameBufferFormat, &m_RprFrameBufferDesc, &m_RprFrameBuffer)                    != RPR_SUCCESS ||
 		ContextCreateFrameBuffer(m_RprContext, m_RprFrameBufferFormat, &m_RprFrameBufferDesc, &m_RprResolvedFrameBuffer)            != RPR_SUCCESS ||
@@ -510,6 +888,26 @@ int FRPRRendererWorker::ResizeFramebuffer()
 		RPR::Error::LogLastError(m_RprContext);
 	}
 
+	// Allocated once per resize, only the AOV bindings are swapped when navigation starts or stops
+	const float	previewScale = CVarRPRMotionResolutionScale.GetValueOnAnyThread();
+	if (!RPR::GetSettings()->IsHybrid && previewScale > 0.0f && previewScale < 1.0f)
+	{
+		rpr_framebuffer_desc	previewDesc;
+		previewDesc.fb_width = m_PreviewWidth = FMath::Max<uint32>(1, m_Width * previewScale);
+		previewDesc.fb_height = m_PreviewHeight = FMath::Max<uint32>(1, m_Height * previewScale);
+
+		if (ContextCreateFrameBuffer(m_RprContext, m_RprFrameBufferFormat, &previewDesc, &m_RprPreviewFrameBuffer) != RPR_SUCCESS ||
+			ContextCreateFrameBuffer(m_RprContext, m_RprFrameBufferFormat, &previewDesc, &m_RprPreviewResolvedFrameBuffer) != RPR_SUCCESS ||
+			ContextCreateFrameBuffer(m_RprContext, m_RprFrameBufferFormat, &previewDesc, &m_RprPreviewColorFrameBuffer) != RPR_SUCCESS)
+		{
+			UE_LOG(LogRPRRenderer, Warning, TEXT("RPR preview framebuffer creation failed, navigating at full resolution"));
+			RPR::Error::LogLastError(m_RprContext);
+			DestroyFrameBuffer(&m_RprPreviewFrameBuffer);
+			DestroyFrameBuffer(&m_RprPreviewResolvedFrameBuffer);
+			DestroyFrameBuffer(&m_RprPreviewColorFrameBuffer);
+		}
+	}
+
 	EnableAdaptiveSampling();
 
 	m_Resize = false;
@@ -549,51 +947,105 @@ void	FRPRRendererWorker::ClearFramebuffer()
 			RPR::Error::LogLastError(m_RprContext);
 		}
 
+	if (m_RprPreviewFrameBuffer != nullptr)
+		if (rprFrameBufferClear(m_RprPreviewFrameBuffer) != RPR_SUCCESS ||
+			rprFrameBufferClear(m_RprPreviewResolvedFrameBuffer) != RPR_SUCCESS ||
+			rprFrameBufferClear(m_RprPreviewColorFrameBuffer) != RPR_SUCCESS)
+		{
+			isFramebufferClearingError = true;
+			UE_LOG(LogRPRRenderer, Error, TEXT("Couldn't clear preview framebuffers"));
+			RPR::Error::LogLastError(m_RprContext);
+		}
+
 	if (!isFramebufferClearingError)
 	{
 		m_CurrentIteration = 0;
 		m_PreviousRenderedIteration = 0;
 		m_ClearFramebuffer = false;
+		m_RenderingFinished = false;
+		m_LastActivePixelCount = 0;
+		m_LastConvergenceTime = 0.0;
+		m_ConvergenceRate = 0.0;
+		m_ConvergedRatio = 0.0f;
+		m_EstimatedSecondsLeft = -1.0f;
+		m_Converged = false;
+		m_ConvergenceDirty = false;
+		m_VarianceDataValid = false;
 #ifdef RPR_VERBOSE
 		UE_LOG(LogRPRRenderer, Log, TEXT("Framebuffer cleared"));
 #endif
 	}
 }
 
-void		FRPRRendererWorker::LockedContextSetParameterAndRestartRender(const bool isFloat, const rpr_int param, const float value, const FString msgSucces, const FString msgFailure)
+void	FRPRRendererWorker::UpdatePreviewBindings()
 {
-	if (m_RprContext == nullptr)
+	const bool	preview = m_PreviewRequested && m_RprPreviewFrameBuffer != nullptr;
+	if (preview == m_PreviewActive)
 		return;
 
-	m_RenderLock.Lock();
+	FScopeLock	lock(&m_RenderLock);
 
-	rpr_int status;
-	if (isFloat)
-		status = rprContextSetParameterByKey1f(m_RprContext, param, value);
+	if (RPR::Context::SetAOV(m_RprContext, RPR::EAOV::Color, preview ? m_RprPreviewColorFrameBuffer : m_RprColorFrameBuffer) != RPR_SUCCESS ||
+		RPR::Context::SetAOV(m_RprContext, m_AOV, preview ? m_RprPreviewFrameBuffer : m_RprFrameBuffer) != RPR_SUCCESS)
+	{
+		UE_LOG(LogRPRRenderer, Warning, TEXT("Couldn't switch to the %s resolution framebuffers"), preview ? TEXT("preview") : TEXT("full"));
+		RPR::Error::LogLastError(m_RprContext);
+		return;
+	}
+
+	// Every attached AOV must share the same size, adaptive sampling only runs at full resolution
+	if (preview)
+		rprContextSetAOV(m_RprContext, RPR_AOV_VARIANCE, nullptr);
 	else
-		status = rprContextSetParameterByKey1u(m_RprContext, param, value);
+		EnableAdaptiveSampling();
+
+	m_PreviewActive = preview;
+	m_ClearFramebuffer = true;
+}
 
+void		FRPRRendererWorker::OnContextParameterSet(const rpr_int status, const RPR::FContextParameterCache::EChange change, const FString &msgSucces, const FString &msgFailure)
+{
 	if (status != RPR_SUCCESS)
 	{
 		UE_LOG(LogRPRRenderer, Error, TEXT("Couldn't set %s"), *msgFailure);
 	}
-	else
+	else if (change != RPR::FContextParameterCache::EChange::None)
 	{
-		RestartRender();
+		if (change == RPR::FContextParameterCache::EChange::Restart)
+			m_ClearFramebuffer = true;
+		m_RenderingFinished = false;
 		UE_LOG(LogRPRRenderer, Log, TEXT("Set %s successfully done"), *msgSucces);
 	}
-
-	m_RenderLock.Unlock();
 }
 
-void		FRPRRendererWorker::LockedContextSetParameterAndRestartRender1u(const rpr_int param, const uint32 value, const FString msgSucces, const FString msgFailure)
+void		FRPRRendererWorker::QueueContextSetParameterAndRestartRender1u(const rpr_int param, const uint32 value, const FString msgSucces, const FString msgFailure)
 {
-	LockedContextSetParameterAndRestartRender(false, param, value, msgSucces, msgFailure);
+	if (m_RprContext == nullptr)
+		return;
+
+	EnqueueCommand([this, param, value, msgSucces, msgFailure]()
+	{
+		FScopeLock	lock(&m_RenderLock);
+
+		RPR::FContextParameterCache::EChange	change;
+		const rpr_int	status = m_ContextParameters.Set1u(m_RprContext, param, value, &change);
+		OnContextParameterSet(status, change, msgSucces, msgFailure);
+	});
 }
 
-void		FRPRRendererWorker::LockedContextSetParameterAndRestartRender1f(const rpr_int param, const float value, const FString msgSucces, const FString msgFailure)
+void		FRPRRendererWorker::QueueContextSetParameterAndRestartRender1f(const rpr_int param, const float value, const FString msgSucces, const FString msgFailure)
 {
-	LockedContextSetParameterAndRestartRender(true, param, value, msgSucces, msgFailure);
+	if (m_RprContext == nullptr)
+		return;
+
+	EnqueueCommand([this, param, value, msgSucces, msgFailure]()
+	{
+		FScopeLock	lock(&m_RenderLock);
+
+		RPR::FContextParameterCache::EChange	change;
+		const rpr_int	status = m_ContextParameters.Set1f(m_RprContext, param, value, &change);
+		OnContextParameterSet(status, change, msgSucces, msgFailure);
+	});
 }
 
 
@@ -675,19 +1127,19 @@ int FRPRRendererWorker::UpdatePostEffectSettings()
 		CHECK_ERROR(status, TEXT("attach to context post effects failed"));
 	}
 
-	status = rprContextSetParameterByKey1u(m_RprContext, RPR_CONTEXT_TONE_MAPPING_TYPE, RPR_TONEMAPPING_OPERATOR_PHOTOLINEAR);
+	status = m_ContextParameters.Set1u(m_RprContext, RPR_CONTEXT_TONE_MAPPING_TYPE, RPR_TONEMAPPING_OPERATOR_PHOTOLINEAR);
 	CHECK_ERROR(status, TEXT("can't set context parameter: RPR_CONTEXT_TONE_MAPPING_TYPE"));
 
-	status = rprContextSetParameterByKey1f(m_RprContext, RPR_CONTEXT_DISPLAY_GAMMA, settings->GammaCorrectionValue);
+	status = m_ContextParameters.Set1f(m_RprContext, RPR_CONTEXT_DISPLAY_GAMMA, settings->GammaCorrectionValue);
 	CHECK_ERROR(status, TEXT("can't set context parameter: RPR_CONTEXT_DISPLAY_GAMMA"));
 
-	status = rprContextSetParameterByKey1f(m_RprContext, RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_SENSITIVITY, settings->PhotolinearTonemapSensitivity);
+	status = m_ContextParameters.Set1f(m_RprContext, RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_SENSITIVITY, settings->PhotolinearTonemapSensitivity);
 	CHECK_ERROR(status, TEXT("can't set context parameter: RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_SENSITIVIT"));
 
-	status = rprContextSetParameterByKey1f(m_RprContext, RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_EXPOSURE, settings->PhotolinearTonemapExposure);
+	status = m_ContextParameters.Set1f(m_RprContext, RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_EXPOSURE, settings->PhotolinearTonemapExposure);
 	CHECK_ERROR(status, TEXT("can't set context parameter: RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_EXPOSURE"));
 
-	status = rprContextSetParameterByKey1f(m_RprContext, RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_FSTOP, settings->PhotolinearTonemapFStop);
+	status = m_ContextParameters.Set1f(m_RprContext, RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_FSTOP, settings->PhotolinearTonemapFStop);
 	CHECK_ERROR(status, TEXT("can't set context parameter: RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_FSTOP"));
 
 	status = m_RprWhiteBalance.SetFloat("colortemp", settings->WhiteBalanceTemperature);
@@ -719,9 +1171,12 @@ void	FRPRRendererWorker::DestroyPendingKills()
 bool	FRPRRendererWorker::PreRenderLoop()
 {
 	SCOPE_CYCLE_COUNTER(STAT_ProRender_PreRender);
+	RPR_TRACE_SCOPE("Pre-render");
 
 	m_PreRenderLock.Lock();
 
+	const uint32	executedCommands = ExecuteCommands();
+
 	URPRSettings *settings = RPR::GetSettings();
 
 	if (m_UpdateTrace)
@@ -754,42 +1209,54 @@ bool	FRPRRendererWorker::PreRenderLoop()
 		DestroyPendingKills();
 	{
 		SCOPE_CYCLE_COUNTER(STAT_ProRender_RebuildScene);
+		RPR_TRACE_SCOPE("Rebuild scene");
 		m_ClearFramebuffer |= m_Scene->RPRThread_Rebuild();
 	}
 	if (m_Resize)
 		ResizeFramebuffer();
+	UpdatePreviewBindings();
+
+	// Navigation renders the full (preview) frame, the region of interest applies once the camera settles
+	m_ActiveRegion = (m_PreviewActive || settings->IsHybrid) ? FIntRect() : m_RegionOfInterest;
+	m_ActiveRegion.Clip(FIntRect(0, 0, m_Width, m_Height));
+	if (m_ActiveRegion.Area() <= 0)
+		m_ActiveRegion = FIntRect();
+
 	if (m_ClearFramebuffer)
 		ClearFramebuffer();
 
-	const bool	isPaused = m_PauseRender || m_BuiltObjects.Num() > 0 || m_DiscardObjects.Num() > 0;
+	// Stays parked until SyncQueue has run the requested PrepareUpdate
+	if (m_PrepareRequested)
+		m_PrepareParked = true;
+
+	const bool	isPaused = m_PauseRender || m_PrepareParked || m_BuiltObjects.Num() > 0 || m_DiscardObjects.Num() > 0;
 
 	if (!settings->IsHybrid)
 	{
 		if (!isPaused || m_CurrentIteration < settings->MaximumRenderIterations)
 		{
 			// Settings expose raycast epsilon in millimeters
-			const float	raycastEpsilon = settings->RaycastEpsilon / 1000.0f;
-			if (FMath::Abs(m_CachedRaycastEpsilon - raycastEpsilon) > FLT_EPSILON)
+			RPR::FContextParameterCache::EChange	change;
+			if (m_ContextParameters.Set1f(m_RprContext, RPR_CONTEXT_RAY_CAST_EPISLON, settings->RaycastEpsilon / 1000.0f, &change) != RPR_SUCCESS)
 			{
-				m_CachedRaycastEpsilon = raycastEpsilon;
-				if (rprContextSetParameterByKey1f(m_RprContext, RPR_CONTEXT_RAY_CAST_EPISLON, m_CachedRaycastEpsilon) != RPR_SUCCESS)
-				{
-					UE_LOG(LogRPRRenderer, Warning, TEXT("Couldn't set raycast epsilon"));
-					RPR::Error::LogLastError(m_RprContext);
-				}
-				else
-					m_ClearFramebuffer = true; // Restart rendering
+				UE_LOG(LogRPRRenderer, Warning, TEXT("Couldn't set raycast epsilon"));
+				RPR::Error::LogLastError(m_RprContext);
 			}
+			else if (change == RPR::FContextParameterCache::EChange::Restart)
+				m_ClearFramebuffer = true; // Restart rendering
 
 			UpdatePostEffectSettings();
 		}
 	}
 	else
 	{
-		if (rprContextSetParameterByKey1f(m_RprContext, RPR_CONTEXT_DISPLAY_GAMMA, settings->GammaCorrectionValue) != RPR_SUCCESS)
+		if (m_ContextParameters.Set1f(m_RprContext, RPR_CONTEXT_DISPLAY_GAMMA, settings->GammaCorrectionValue) != RPR_SUCCESS)
 			UE_LOG(LogRPRRenderer, Warning, TEXT("Couldn't apply DISPLAY_GAMMA post effect properties"));
 	}
 
+	// Only now, a restart queued before IsRenderingFinished was called has cleared m_RenderingFinished
+	m_PendingCommands.Subtract(executedCommands);
+
 	m_PreRenderLock.Unlock();
 
 	return isPaused;
@@ -799,6 +1266,13 @@ int	FRPRRendererWorker::InitializeDenoiser()
 {
 	int status;
 
+	// Started in the background when the denoiser was enabled before the scene was built
+	if (!IRPRCore::GetResources()->RequestImageFilterLibrary().Get())
+	{
+		UE_LOG(LogRPRRenderer, Error, TEXT("Denoiser library is not available"));
+		return RIF_ERROR_UNSUPPORTED;
+	}
+
 	auto rprSdk = FModuleManager::GetModuleChecked<FRPR_SDKModule>("RPR_SDK");
 	FString path = FPaths::ConvertRelativePathToFull(rprSdk.GetDLLsDirectory(TEXT("RadeonProImageProcessingSDK")), TEXT("../../models"));
 
@@ -906,6 +1380,8 @@ int FRPRRendererWorker::CreateDenoiserFilter(RifFilterType filterType)
 
 int FRPRRendererWorker::ApplyDenoiser()
 {
+	RPR_TRACE_SCOPE("Denoise");
+
 	auto settings = RPR::GetSettings();
 	int status;
 
@@ -923,6 +1399,42 @@ int FRPRRendererWorker::ApplyDenoiser()
 	return RPR_SUCCESS;
 }
 
+/*
+* Sizes the number of iterations rendered by the next rprContextRender call.
+* Tahoe splits the iterations of a call across all the enabled devices, so a single
+* iteration per call leaves the fastest GPUs waiting on the slowest one at every sync.
+* The batch grows until a call takes about TargetRenderCallTime, based on the measured time per iteration.
+*/
+uint32	FRPRRendererWorker::UpdateIterationBatch(uint32 iterationCeiling)
+{
+	URPRSettings	*settings = RPR::GetSettings();
+	if (settings->IsHybrid)
+		return 1;
+
+	static const uint32	kMaxIterationsPerRender = 64;
+
+	// First iteration after a restart is always alone, for a quick preview
+	uint32	batch = 1;
+	if (settings->bBalanceDeviceWorkload && m_CurrentIteration > 0 && m_SecondsPerIteration > 0.0)
+	{
+		const uint32	maxBatch = FMath::Min(m_IterationsPerRender * 2, kMaxIterationsPerRender);
+		const double	idealBatch = settings->TargetRenderCallTime / m_SecondsPerIteration;
+
+		// At most double each call, so one fast measure doesn't stall the viewport for long
+		batch = (uint32)FMath::Clamp(idealBatch, 1.0, (double)maxBatch);
+	}
+	if (iterationCeiling > m_CurrentIteration)
+		batch = FMath::Min(batch, iterationCeiling - m_CurrentIteration);
+
+	if (m_ContextParameters.Set1u(m_RprContext, RPR_CONTEXT_ITERATIONS, batch) != RPR_SUCCESS)
+	{
+		UE_LOG(LogRPRRenderer, Warning, TEXT("Couldn't set CONTEXT_ITERATIONS to %d"), batch);
+		return m_IterationsPerRender;
+	}
+	m_IterationsPerRender = batch;
+	return m_IterationsPerRender;
+}
+
 int	FRPRRendererWorker::RunDenoiser()
 {
 	int status;
@@ -949,9 +1461,9 @@ int	FRPRRendererWorker::RunDenoiser()
 		*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
 		*dstPixels++ = FMath::Clamp(*srcPixels++ * 255.0f, 0.0f, 255.0f);
 	}
-	m_DataLock.Lock();
-	FMemory::Memcpy(m_RenderData.GetData(), m_DstFramebufferData.GetData(), m_DstFramebufferData.Num());
-	m_DataLock.Unlock();
+	// Outside of the region of interest, the framebuffers were cleared and not sampled
+	const FIntRect	fullRegion(0, 0, m_RprFrameBufferDesc.fb_width, m_RprFrameBufferDesc.fb_height);
+	CommitRenderData(m_ActiveRegion.Area() > 0 ? m_ActiveRegion : fullRegion, false);
 
 	return RPR_SUCCESS;
 }
@@ -977,10 +1489,69 @@ void	FRPRRendererWorker::EnableAdaptiveSampling()
 	}
 }
 
-bool	FRPRRendererWorker::IsAdaptiveSamplingFinalized()
+/*
+* Counts the pixels of region whose variance is still above the adaptive sampling threshold,
+* with the same per pixel variance as the convergence heat map.
+*/
+bool	FRPRRendererWorker::CountActivePixels(const FIntRect &region, uint32 &outActivePixels)
+{
+	const uint32	width = m_RprFrameBufferDesc.fb_width;
+	const uint32	height = m_RprFrameBufferDesc.fb_height;
+	const float		threshold = FMath::Max(RPR::GetSettings()->NoiseThreshold, SMALL_NUMBER);
+
+	if (region.Max.X > (int32)width || region.Max.Y > (int32)height)
+		return false;
+	if (!ReadVarianceData())
+		return false;
+
+	uint32	activePixels = 0;
+	for (int32 y = region.Min.Y; y < region.Max.Y; ++y)
+	{
+		const float	*src = m_VarianceData.GetData() + (y * width + region.Min.X) * 4;
+		for (int32 x = region.Min.X; x < region.Max.X; ++x, src += 4)
+			activePixels += (src[0] + src[1] + src[2]) / 3.0f > threshold;
+	}
+	outActivePixels = activePixels;
+	return true;
+}
+
+/*
+* Samples how many pixels adaptive sampling still renders, returns true once none are left.
+* The time left is the earliest of: every pixel converged at the smoothed pace seen so far, or SamplingMax reached.
+*/
+bool	FRPRRendererWorker::UpdateConvergence()
 {
-	rpr_uint activePixels;
-	RPR::Context::GetInfo(m_RprContext, RPR_CONTEXT_ACTIVE_PIXEL_COUNT, sizeof(activePixels), &activePixels);
+	rpr_uint	activePixels = 0;
+	uint32		pixelCount = FMath::Max(m_Width * m_Height, 1u);
+	if (m_ActiveRegion.Area() > 0)
+	{
+		// RPR counts over the whole framebuffer, where the pixels outside of the region of interest are never sampled
+		if (!CountActivePixels(m_ActiveRegion, activePixels))
+			return false;
+		pixelCount = m_ActiveRegion.Area();
+	}
+	else if (RPR::Context::GetInfo(m_RprContext, RPR_CONTEXT_ACTIVE_PIXEL_COUNT, sizeof(activePixels), &activePixels) != RPR_SUCCESS)
+		return false;
+
+	const double	now = FPlatformTime::Seconds();
+	if (m_LastConvergenceTime > 0.0 && m_LastActivePixelCount > activePixels && now > m_LastConvergenceTime)
+	{
+		const double	pixelsPerSecond = (m_LastActivePixelCount - activePixels) / (now - m_LastConvergenceTime);
+		m_ConvergenceRate = (m_ConvergenceRate > 0.0) ? FMath::Lerp(m_ConvergenceRate, pixelsPerSecond, 0.25) : pixelsPerSecond;
+	}
+	m_LastActivePixelCount = activePixels;
+	m_LastConvergenceTime = now;
+
+	m_ConvergedRatio = 1.0f - FMath::Min((float)activePixels / pixelCount, 1.0f);
+
+	const uint32	samplingMax = RPR::GetSettings()->SamplingMax;
+	double			secondsLeft = (samplingMax > m_CurrentIteration && m_SecondsPerIteration > 0.0) ? (samplingMax - m_CurrentIteration) * m_SecondsPerIteration : -1.0;
+	if (m_ConvergenceRate > 0.0)
+	{
+		const double	convergedIn = activePixels / m_ConvergenceRate;
+		secondsLeft = (secondsLeft < 0.0) ? convergedIn : FMath::Min(secondsLeft, convergedIn);
+	}
+	m_EstimatedSecondsLeft = (activePixels == 0) ? 0.0f : (float)secondsLeft;
 
 	return activePixels == 0;
 }
@@ -993,9 +1564,18 @@ uint32	FRPRRendererWorker::Run()
 
 	while (m_StopTaskCounter.GetValue() == 0)
 	{
+		ExportPendingScene();
+
 		const bool isPaused = PreRenderLoop();
-		const bool checkFinalized = !settings->IsHybrid && settings->EnableAdaptiveSampling && m_CurrentIteration > settings->SamplingMin;
-		const bool adaptiveSamplingFinalized = checkFinalized ? IsAdaptiveSamplingFinalized() : false;
+		const bool trackConvergence = !settings->IsHybrid && settings->EnableAdaptiveSampling && !m_PreviewActive;
+		// Nothing changes while idle, only measure after a render
+		if (trackConvergence && m_ConvergenceDirty)
+		{
+			m_Converged = UpdateConvergence();
+			m_ConvergenceDirty = false;
+		}
+		const bool converged = trackConvergence && m_Converged;
+		const bool adaptiveSamplingFinalized = converged && m_CurrentIteration > settings->SamplingMin;
 
 		const uint32 iterationCeiling =
 			(settings->IsHybrid)
@@ -1006,7 +1586,7 @@ uint32	FRPRRendererWorker::Run()
 
 		if (isPaused || renderingFinished)
 		{
-			if (settings->UseDenoiser && !denoised && renderingFinished)
+			if (settings->UseDenoiser && !denoised && renderingFinished && !m_PreviewActive)
 			{
 				const bool isSuccess = (ApplyDenoiser() == RPR_SUCCESS);
 
@@ -1018,32 +1598,63 @@ uint32	FRPRRendererWorker::Run()
 
 				denoised = isSuccess;
 			}
-			FPlatformProcess::Sleep(0.1f);
+
+			// A restart queued since PreRenderLoop invalidates this result
+			m_PreRenderLock.Lock();
+			m_RenderingFinished = renderingFinished && !m_ClearFramebuffer;
+			m_PreRenderLock.Unlock();
+
+			// Nothing to render: block until the game thread queues work (restart, resize, build, unpause..)
+			const float	idlePollInterval = CVarRPRIdlePollInterval.GetValueOnAnyThread();
+			if (idlePollInterval > 0.0f)
+				m_WakeUpEvent->Wait(FTimespan::FromSeconds(idlePollInterval));
+			else
+				m_WakeUpEvent->Wait();
 			continue;
 		}
 		if (m_RenderLock.TryLock())
 		{
+			uint32	renderedIterations = 0;
 			{
 				SCOPE_CYCLE_COUNTER(STAT_ProRender_Render);
+				RPR_TRACE_SCOPE("Render");
 
 				if (!settings->IsHybrid)
 				{
-					int status = rprContextSetParameterByKey1u(m_RprContext, RPR_CONTEXT_FRAMECOUNT, m_CurrentIteration);
+					int status = m_ContextParameters.Set1u(m_RprContext, RPR_CONTEXT_FRAMECOUNT, m_CurrentIteration);
 					CHECK_WARNING(status, TEXT("Can't set CONTEXT_FRAMECOUNT"));
 				}
+				renderedIterations = UpdateIterationBatch(iterationCeiling);
 
 				// Render + Resolve
-				if (RPR::Context::Render(m_RprContext) != RPR_SUCCESS)
+				const double	renderStartTime = FPlatformTime::Seconds();
+				const RPR::FResult	renderStatus = (m_ActiveRegion.Area() > 0)
+					? RPR::Context::RenderTile(m_RprContext, m_ActiveRegion.Min.X, m_ActiveRegion.Max.X, m_ActiveRegion.Min.Y, m_ActiveRegion.Max.Y)
+					: RPR::Context::Render(m_RprContext);
+				if (renderStatus != RPR_SUCCESS)
 				{
 					RPR::Error::LogLastError(m_RprContext);
 					m_RenderLock.Unlock();
 					UE_LOG(LogRPRRenderer, Error, TEXT("Couldn't render iteration %d, stopping.."), m_CurrentIteration);
 					break;
 				}
+
+				// Smoothed, scene or camera changes shouldn't make the batch size oscillate
+				const double	secondsPerIteration = (FPlatformTime::Seconds() - renderStartTime) / renderedIterations;
+				m_SecondsPerIteration = (m_SecondsPerIteration > 0.0) ? FMath::Lerp(m_SecondsPerIteration, secondsPerIteration, 0.25) : secondsPerIteration;
 			}
 			{
 				SCOPE_CYCLE_COUNTER(STAT_ProRender_Resolve);
-				if (!settings->IsHybrid)
+				RPR_TRACE_SCOPE("Resolve");
+				if (!settings->IsHybrid && m_PreviewActive)
+				{
+					if (RPR::Context::ResolveFrameBuffer(m_RprContext, m_RprPreviewFrameBuffer, m_RprPreviewResolvedFrameBuffer) != RPR_SUCCESS)
+					{
+						RPR::Error::LogLastError(m_RprContext);
+						UE_LOG(LogRPRRenderer, Error, TEXT("Couldn't resolve preview framebuffer at iteration %d"), m_CurrentIteration);
+					}
+				}
+				else if (!settings->IsHybrid)
 				{
 					if (RPR::Context::ResolveFrameBuffer(m_RprContext, m_RprFrameBuffer, m_RprResolvedFrameBuffer)                         != RPR_SUCCESS ||
 						RPR::Context::ResolveFrameBuffer(m_RprContext, m_RprAovDepthBuffer, m_RprAovDepthResolvedBuffer)                   != RPR_SUCCESS ||
@@ -1067,14 +1678,22 @@ uint32	FRPRRendererWorker::Run()
 			}
 			m_RenderLock.Unlock();
 
+			m_VarianceDataValid = false;
+			m_ConvergenceDirty = true;
 			BuildFramebufferData();
 
-			const uint32	sampleCount = FGenericPlatformMath::Min((m_CurrentIteration + 4) / 4, m_NumDevices);
+			// A batched call renders exactly the iterations it was asked for, whatever the device count
+			const uint32	sampleCount = (settings->bBalanceDeviceWorkload && !settings->IsHybrid)
+				? renderedIterations
+				: FGenericPlatformMath::Min((m_CurrentIteration + 4) / 4, m_NumDevices);
 			m_CurrentIteration += sampleCount;
 			denoised = false;
 		}
 		else
-			FPlatformProcess::Sleep(0.1f);
+		{
+			// The game thread holds the render lock (save, AOV switch, immediate release) and wakes us when done
+			m_WakeUpEvent->Wait(FTimespan::FromMilliseconds(100));
+		}
 	}
 	return 0;
 }
@@ -1082,10 +1701,22 @@ uint32	FRPRRendererWorker::Run()
 void	FRPRRendererWorker::Stop()
 {
 	m_StopTaskCounter.Increment();
+	WakeUp();
 }
 
 void	FRPRRendererWorker::Exit()
 {
+	// Stopped with queued commands, or before picking up a queued export
+	m_PreRenderLock.Lock();
+	m_PendingCommands.Subtract(ExecuteCommands());
+	if (m_OnExportCompleted)
+	{
+		TFunction<void(bool)>	onCompleted = MoveTemp(m_OnExportCompleted);
+		m_OnExportCompleted = nullptr;
+		AsyncTask(ENamedThreads::GameThread, [onCompleted]() { onCompleted(false); });
+	}
+	m_PreRenderLock.Unlock();
+
 	ReleaseResources();
 }
 
@@ -1096,6 +1727,7 @@ void	FRPRRendererWorker::AddPendingKill(ARPRActor *actor)
 	m_PreRenderLock.Lock();
 	m_KillQueue.AddUnique(actor);
 	m_PreRenderLock.Unlock();
+	WakeUp();
 }
 
 void	FRPRRendererWorker::SafeRelease_Immediate(URPRSceneComponent *component)
@@ -1118,6 +1750,7 @@ void	FRPRRendererWorker::SafeRelease_Immediate(URPRSceneComponent *component)
 	m_DataLock.Unlock();
 	m_RenderLock.Unlock();
 	m_PreRenderLock.Unlock();
+	WakeUp();
 }
 
 bool	FRPRRendererWorker::CanSafelyKill(AActor *actor) const
@@ -1194,6 +1827,11 @@ int FRPRRendererWorker::DestroyBuffers()
 	status = DestroyFrameBuffer(&m_RprVarianceResolvedBuffer);
 	CHECK_WARNING(status, TEXT("can't destroy variance resolved framebuffer"));
 
+	// AOVs are unset above whichever set they were bound to
+	DestroyFrameBuffer(&m_RprPreviewFrameBuffer);
+	DestroyFrameBuffer(&m_RprPreviewResolvedFrameBuffer);
+	DestroyFrameBuffer(&m_RprPreviewColorFrameBuffer);
+
 	return RPR_SUCCESS;
 }
 
@@ -1236,6 +1874,8 @@ int FRPRRendererWorker::ReleaseResources()
 	status = DestroyPostEffects();
 	CHECK_WARNING(status, TEXT("can't destroy post effects"));
 
+	m_ContextParameters.Reset();
+
 	m_PreRenderLock.Lock();
 
 	const uint32	objectCount = m_BuildQueue.Num();
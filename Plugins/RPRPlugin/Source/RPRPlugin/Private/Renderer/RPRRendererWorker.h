@@ -18,9 +18,13 @@
 
 #include "RadeonProRender.h"
 #include "HAL/Runnable.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Containers/Queue.h"
+#include "Async/Future.h"
 #include "RPRPlugin.h"
 #include "RPRSettings.h"
 #include "Typedefs/RPRTypedefs.h"
+#include "Helpers/RPRContextParameterCache.h"
 #include "ImageFilter/ImageFilter.h"
 
 class FRPRRendererWorker : public FRunnable
@@ -45,23 +49,51 @@ public:
 
 	bool			CanSafelyKill(AActor *actor) const;
 	bool			IsBuildingObjects() const { return m_IsBuildingObjects; }
-	bool			ResizeFramebuffer(uint32 width, uint32 height);
+	void			ResizeFramebuffer(uint32 width, uint32 height);
 	bool			RestartRender();
 	void			SetTrace(bool trace, const FString &tracePath);
-	int				SaveToFile(const FString &filename);
+
+	/* Queued, the scene (.frs) or framebuffer is written by the RPR thread between two iterations */
+	void			SaveToFile(const FString &filename);
+
+	/* Queues a GLTF export run by the RPR thread between two iterations, onCompleted is called on the game thread */
+	void			ExportToGLTF(const FString &filename, TFunction<void(bool)> onCompleted);
 	void			SetQualitySettings(ERPRQualitySettings qualitySettings);
 	int 			SetDenoiserSettings(ERPRDenoiserOption denoiserOption);
 	void			SetSamplingMinSPP();
 	void			SetSamplingNoiseThreshold();
 	uint32			Iteration() const { return m_CurrentIteration; }
+	/* Share of the pixels adaptive sampling has converged, and the estimated seconds left before the render stops (negative when unknown) */
+	float			ConvergedRatio() const { return m_ConvergedRatio; }
+	float			EstimatedSecondsLeft() const { return m_EstimatedSecondsLeft; }
+	bool			IsRenderingFinished() const { return m_RenderingFinished && m_PendingCommands.GetValue() == 0; }
+	/* Queued like SaveToFile, the future is set once the last readback is written */
+	TFuture<bool>	SaveRenderData(const FString &filename);
 	void			SetPaused(bool paused);
 	void			SetAOV(RPR::EAOV AOV);
-	int 			ApplyDenoiser();
+
+	/* Renders to the reduced resolution framebuffers while the viewport is navigated */
+	void			SetInteractivePreview(bool preview);
+
+	/* Only samples this rectangle of the framebuffer (in pixels), the rest keeps the last render. Empty renders the full frame */
+	void			SetRegionOfInterest(const FIntRect &region);
+
+	/* Rectangle of the framebuffer data written since the last call, lock m_DataLock around it and GetFramebufferData */
+	FIntRect		ConsumeDirtyRegion();
+
+	/* Wakes the RPR thread up if it is idle, call after queuing work for it. Safe from any thread */
+	void			WakeUp();
+
+	/* Queues a denoise of the current render on the RPR thread */
+	void			RequestDenoise();
+
+	/* Parks the RPR thread until the next SyncQueue has called PrepareUpdate on the scene components. Safe from any thread */
+	void			RequestPrepareUpdate();
 
 	const uint8		*GetFramebufferData()
 	{
 		m_PreviousRenderedIteration = m_CurrentIteration;
-		return m_RenderData.GetData();
+		return m_HeatMapData.Num() > 0 ? m_HeatMapData.GetData() : m_RenderData.GetData();
 	}
 
 public:
@@ -70,9 +102,16 @@ public:
 
 private:
 
-	void		LockedContextSetParameterAndRestartRender(const bool isFloat, const rpr_int param, const float value, const FString msgSucces, const FString msgFailure);
-	void		LockedContextSetParameterAndRestartRender1u(const rpr_int param, const uint32 value, const FString msgSucces, const FString msgFailure);
-	void		LockedContextSetParameterAndRestartRender1f(const rpr_int param, const float value, const FString msgSucces, const FString msgFailure);
+	/*
+	* Game thread requests are queued and run by the RPR thread at the start of PreRenderLoop,
+	* so the caller never waits behind an in-flight render. Commands run in order, with m_PreRenderLock held.
+	*/
+	void		EnqueueCommand(TFunction<void()> &&command);
+	uint32		ExecuteCommands();
+
+	void		OnContextParameterSet(const rpr_int status, const RPR::FContextParameterCache::EChange change, const FString &msgSucces, const FString &msgFailure);
+	void		QueueContextSetParameterAndRestartRender1u(const rpr_int param, const uint32 value, const FString msgSucces, const FString msgFailure);
+	void		QueueContextSetParameterAndRestartRender1f(const rpr_int param, const float value, const FString msgSucces, const FString msgFailure);
 
 	int         CreatePostEffectSettings();
 	int         UpdatePostEffectSettings();
@@ -87,13 +126,21 @@ private:
 	void		BuildQueuedObjects();
 	int         ResizeFramebuffer();
 	void		ClearFramebuffer();
+	void		ExportPendingScene();
+	void		UpdatePreviewBindings();
+	void		CommitRenderData(const FIntRect &region, bool showConvergence);
 	void		DestroyPendingKills();
 	bool		PreRenderLoop();
 	int			InitializeDenoiser();
 	int			CreateDenoiserFilter(RifFilterType type);
 	int 		RunDenoiser();
 	void		EnableAdaptiveSampling();
-	bool		IsAdaptiveSamplingFinalized();
+	bool		ReadVarianceData();
+	bool		CountActivePixels(const FIntRect &region, uint32 &outActivePixels);
+	bool		UpdateConvergence();
+	void		DrawConvergenceHeatMap(const FIntRect &region);
+	uint32		UpdateIterationBatch(uint32 iterationCeiling);
+	int 		ApplyDenoiser();
 	int         SaveFrameBuffer(const FString& fileName);
 	int         SaveSceneToRPR(const FString& fileName);
 	int			SaveDenoisedBuffer(const FString& fileName);
@@ -104,6 +151,11 @@ private:
 	FThreadSafeCounter			m_StopTaskCounter;
 	FCriticalSection			m_RenderLock;
 	FCriticalSection			m_PreRenderLock;
+	FEvent						*m_WakeUpEvent;
+
+	TQueue<TFunction<void()>, EQueueMode::Mpsc>	m_Commands;
+	FThreadSafeCounter			m_PendingCommands;
+	FThreadSafeBool				m_PrepareRequested;
 
 	class FRPRPluginModule		*m_Plugin;
 	class ARPRScene				*m_Scene;
@@ -112,6 +164,8 @@ private:
 	uint32						m_PreviousRenderedIteration;
 
 	uint32						m_NumDevices;
+	uint32						m_IterationsPerRender;
+	double						m_SecondsPerIteration;
 	uint32						m_Width;
 	uint32						m_Height;
 
@@ -137,6 +191,13 @@ private:
 	RPR::FFrameBuffer			m_RprVarianceBuffer;
 	RPR::FFrameBuffer			m_RprVarianceResolvedBuffer;
 
+	// Reduced resolution set, bound instead of the full one while navigating
+	RPR::FFrameBuffer			m_RprPreviewFrameBuffer;
+	RPR::FFrameBuffer			m_RprPreviewResolvedFrameBuffer;
+	RPR::FFrameBuffer			m_RprPreviewColorFrameBuffer;
+	uint32						m_PreviewWidth;
+	uint32						m_PreviewHeight;
+
 
 	RPR::FPostEffect            m_RprWhiteBalance;
 	RPR::FPostEffect            m_RprGammaCorrection;
@@ -144,20 +205,43 @@ private:
 	RPR::FPostEffect            m_RprNormalization;
 
 	TArray<float>				m_SrcFramebufferData;
+	TArray<float>				m_VarianceData;
 	TArray<uint8>				m_DstFramebufferData;
 	TArray<uint8>				m_RenderData;
+	TArray<uint8>				m_HeatMapData;
 
 	bool						m_Resize;
 	bool						m_IsBuildingObjects;
 	bool						m_ClearFramebuffer;
 	bool						m_PauseRender;
-
-	float						m_CachedRaycastEpsilon;
+	FThreadSafeBool				m_RenderingFinished;	// Read by the game thread
+	FThreadSafeBool				m_PreviewRequested;		// Written by the game thread
+	bool						m_PreviewActive;
+	bool						m_PrepareParked;
+
+	FIntRect					m_RegionOfInterest;
+	FIntRect					m_ActiveRegion;
+	FIntRect					m_DirtyRegion;
+
+	// Every context parameter the worker sets goes through it, unchanged values are skipped
+	RPR::FContextParameterCache	m_ContextParameters;
+
+	uint32						m_LastActivePixelCount;
+	double						m_LastConvergenceTime;
+	double						m_ConvergenceRate;
+	float						m_ConvergedRatio;
+	float						m_EstimatedSecondsLeft;
+	bool						m_Converged;
+	bool						m_ConvergenceDirty;		// Samples were rendered since the last UpdateConvergence
+	bool						m_VarianceDataValid;	// m_VarianceData holds the last rendered samples
 
 	bool						m_Trace;
 	bool						m_UpdateTrace;
 	FString						m_TracePath;
 
+	FString						m_ExportPath;
+	TFunction<void(bool)>		m_OnExportCompleted;
+
 	TArray<class ARPRActor*>	m_BuildQueue;
 	TArray<class ARPRActor*>	m_BuiltObjects;
 	TArray<class ARPRActor*>	m_DiscardObjects;
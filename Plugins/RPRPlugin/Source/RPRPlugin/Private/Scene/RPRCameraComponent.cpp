@@ -49,6 +49,7 @@ void	URPRCameraComponent::SetAsActiveCamera()
 {
 	check(Scene != NULL);
 	Scene->m_ActiveCamera = this;
+	SetComponentTickEnabled(true);
 
 	if (m_RprCamera == NULL)
 		return;
@@ -56,6 +57,7 @@ void	URPRCameraComponent::SetAsActiveCamera()
 	m_RefreshLock.Lock();
 	m_RebuildFlags |= PROPERTY_REBUILD_ACTIVE_CAMERA;
 	m_RefreshLock.Unlock();
+	WakeRenderer();
 
 	if (!m_Orbit)
 		RefreshProperties(false);
@@ -270,6 +272,12 @@ void	URPRCameraComponent::UpdateOrbitCamera()
 	}
 }
 
+bool	URPRCameraComponent::NeedsTick() const
+{
+	// Only the active camera follows its source, the others stop ticking until they're activated
+	return (Scene != NULL && Scene->m_ActiveCamera == this) || Super::NeedsTick();
+}
+
 void	URPRCameraComponent::TickComponent(float deltaTime, ELevelTick tickType, FActorComponentTickFunction *tickFunction)
 {
 	SCOPE_CYCLE_COUNTER(STAT_ProRender_UpdateCameras);
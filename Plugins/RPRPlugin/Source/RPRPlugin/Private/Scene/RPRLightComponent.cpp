@@ -16,7 +16,9 @@
 
 #include "Scene/RPRLightComponent.h"
 #include "Scene/RPRScene.h"
+#include "Scene/RPRIESProfileUserData.h"
 #include "Helpers/RPRHelpers.h"
+#include "Helpers/RPRTrace.h"
 
 #include "Engine/TextureLightProfile.h"
 #include "Engine/TextureCube.h"
@@ -34,6 +36,10 @@
 #include "Helpers/RPRLightHelpers.h"
 #include "Helpers/RPRSceneHelpers.h"
 #include "Constants/RPRConstants.h"
+#include "Misc/FileHelper.h"
+#include "Misc/ScopeLock.h"
+#include "Misc/SecureHash.h"
+#include "HAL/IConsoleManager.h"
 
 DEFINE_LOG_CATEGORY_STATIC(LogRPRLightComponent, Log, All);
 
@@ -61,8 +67,71 @@ enum
 	PROPERTY_REBUILD_ENV_LIGHT_CUBEMAP = 0x20,
 };
 
+static TAutoConsoleVariable<int32> CVarRPRPollLights(
+	TEXT("RPR.Sync.PollLights"),
+	0,
+	TEXT("Also compare every RPR light against its source each tick.\n")
+	TEXT("Only needed when lights are animated in the editor through setters that don't notify (ie. SetIntensity from Sequencer)."));
+
+FCriticalSection									URPRLightComponent::WatchedLightsLock;
+TMap<const UActorComponent*, URPRLightComponent*>	URPRLightComponent::WatchedLights;
+
+static FDelegateHandle	LightRenderStateDirtyHandle;
+#if WITH_EDITOR
+static FDelegateHandle	LightPropertyChangedHandle;
+#endif
+
+#if WITH_EDITOR
+namespace
+{
+	using FIESProfile = TSharedRef<TArray<uint8>, ESPMode::ThreadSafe>;
+
+	// Profiles read from the source files, keyed by the MD5 of the source file. Transient: the textures are left untouched
+	FCriticalSection			GIESProfilesLock;
+	TMap<FString, FIESProfile>	GIESProfiles;
+
+	TOptional<FIESProfile>	LoadIESProfileFromSource(const UAssetImportData* AssetImportData)
+	{
+		// The hash recorded at import is available even when the source file is not
+		FString	hash;
+		if (AssetImportData->SourceData.SourceFiles.Num() > 0 && AssetImportData->SourceData.SourceFiles[0].FileHash.IsValid())
+			hash = LexToString(AssetImportData->SourceData.SourceFiles[0].FileHash);
+
+		if (!hash.IsEmpty())
+		{
+			FScopeLock	lock(&GIESProfilesLock);
+			if (const FIESProfile* profile = GIESProfiles.Find(hash))
+				return *profile;
+		}
+
+		// Read without the lock, lights using other profiles don't wait for it
+		const FString	filePath = AssetImportData->GetFirstFilename();
+		FIESProfile		profile = MakeShared<TArray<uint8>, ESPMode::ThreadSafe>();
+		if (filePath.IsEmpty() || !FFileHelper::LoadFileToArray(*profile, *filePath))
+			return TOptional<FIESProfile>();
+
+		if (hash.IsEmpty())
+		{
+			FMD5	md5;
+			md5.Update(profile->GetData(), profile->Num());
+			FMD5Hash	fileHash;
+			fileHash.Set(md5);
+			hash = LexToString(fileHash);
+		}
+		profile->Add(0);
+
+		FScopeLock	lock(&GIESProfilesLock);
+		if (const FIESProfile* cachedProfile = GIESProfiles.Find(hash))
+			return *cachedProfile; // Read by another light meanwhile
+		GIESProfiles.Add(hash, profile);
+		return profile;
+	}
+}
+#endif
+
 URPRLightComponent::URPRLightComponent()
 :	m_RprLight(NULL)
+,	m_PropertiesDirty(true)
 {
 	PrimaryComponentTick.bCanEverTick = true;
 }
@@ -78,23 +147,27 @@ FLinearColor	BuildRPRLightColor(const ULocalLightComponent *lightComponent, ELig
 
 int URPRLightComponent::BuildIESLight(const UPointLightComponent *lightComponent)
 {
-#if WITH_EDITOR
 	int status;
 
 	check(lightComponent->IESTexture != NULL);
 
-	// We want to get the original .ies file (UE4 bakes into its own format in a texture, would be painful to generate back)
-	// This means this won t be available at runtime -> needs to be cooked at package time in the texture user data for example
-	const UAssetImportData	*assetImportData = lightComponent->IESTexture->AssetImportData;
-	if (assetImportData == NULL)
+	// RPR needs the original .ies file, UE4 bakes it into its own texture format
+	UTextureLightProfile	*iesTexture = lightComponent->IESTexture;
+	const TArray<uint8>		*iesProfile = nullptr;
+	if (const URPRIESProfileUserData *userData = iesTexture->GetAssetUserData<URPRIESProfileUserData>())
+		iesProfile = &userData->Profile;
+#if WITH_EDITOR
+	TOptional<FIESProfile>	sourceProfile;
+	if (iesProfile == nullptr && iesTexture->AssetImportData != nullptr)
 	{
-		UE_LOG(LogRPRLightComponent, Warning, TEXT("Couldn't create IES light: couldn't find source IES file"));
-		return RPR_SUCCESS;
+		sourceProfile = LoadIESProfileFromSource(iesTexture->AssetImportData);
+		if (sourceProfile.IsSet())
+			iesProfile = &sourceProfile.GetValue().Get();
 	}
-	const FString	filePath = assetImportData->GetFirstFilename();
-	if (filePath.IsEmpty() || !FPaths::FileExists(filePath))
+#endif
+	if (iesProfile == nullptr || iesProfile->Num() == 0)
 	{
-		UE_LOG(LogRPRLightComponent, Warning, TEXT("Couldn't create IES light: couldn't find source IES file"));
+		UE_LOG(LogRPRLightComponent, Warning, TEXT("Couldn't create IES light: the IES profile of '%s' isn't available, its source file is missing"), *iesTexture->GetPathName());
 		return RPR_SUCCESS;
 	}
 	const float			affectsWorld = (m_CachedAffectsWorld ? 1.0f : 0.0f);
@@ -107,7 +180,7 @@ int URPRLightComponent::BuildIESLight(const UPointLightComponent *lightComponent
 	status = rprContextCreateIESLight(rprContext, &m_RprLight);
 	CHECK_ERROR(status, TEXT("can't create IES light"));
 
-	status = rprIESLightSetImageFromFile(m_RprLight, TCHAR_TO_ANSI(*filePath), 256, 256);
+	status = rprIESLightSetImageFromIESdata(m_RprLight, reinterpret_cast<const rpr_char*>(iesProfile->GetData()), 256, 256);
 	CHECK_ERROR(status, TEXT("can't set image for IES light"));
 
 	status = rprIESLightSetRadiantPower3f(m_RprLight, lightColor.R, lightColor.G, lightColor.B);
@@ -122,8 +195,13 @@ int URPRLightComponent::BuildIESLight(const UPointLightComponent *lightComponent
 	SrcComponent->SetComponentToWorld(newComponentTransform);
 
 	return RPR_SUCCESS;
-#else
-	return RPR_ERROR_UNSUPPORTED; // AssetUserData not available in runtime builds
+}
+
+void	URPRLightComponent::ClearIESCache()
+{
+#if WITH_EDITOR
+	FScopeLock	lock(&GIESProfilesLock);
+	GIESProfiles.Empty();
 #endif
 }
 
@@ -346,6 +424,8 @@ bool	URPRLightComponent::PostBuild()
 	if (Scene == NULL || !IsSrcComponentValid())
 		return false;
 
+	BindPropertyChangeEvents();
+
 	const USkyLightComponent* skyLightComponent = Cast<USkyLightComponent>(SrcComponent);
 	if (skyLightComponent == NULL)
 		return Super::PostBuild();
@@ -446,6 +526,8 @@ bool	URPRLightComponent::RPRThread_Update()
 		return false;
 	}
 
+	RPR_TRACE_SCOPE_DETAIL("Update light", *GetOwner()->GetName());
+
 	const bool	rebuild = m_RebuildFlags != PROPERTY_REBUILD_TRANSFORMS;
 
 	const ULightComponent		*lightComponent = Cast<ULightComponent>(SrcComponent);
@@ -525,8 +607,11 @@ void	URPRLightComponent::TickComponent(float deltaTime, ELevelTick tickType, FAc
 
 	if (!settings->bSync)
 		return;
-	// Check all cached properties (might be a better way)
-	// There is PostEditChangeProperty but this is editor only
+
+	// Editor edits are notified: nothing to check until then
+	if (!m_PropertiesDirty && !ShouldPollProperties())
+		return;
+	m_PropertiesDirty = false;
 
 	m_RefreshLock.Lock();
 
@@ -587,8 +672,90 @@ void	URPRLightComponent::TickComponent(float deltaTime, ELevelTick tickType, FAc
 	m_RefreshLock.Unlock();
 }
 
+bool	URPRLightComponent::ShouldPollProperties() const
+{
+	if (CVarRPRPollLights.GetValueOnGameThread() != 0)
+		return true;
+
+	// Static lights can't be changed at runtime, gameplay setters like SetIntensity() don't raise any event
+	const UWorld	*world = GetWorld();
+	return world != NULL && world->IsGameWorld() &&
+		SrcComponent != NULL && SrcComponent->Mobility != EComponentMobility::Static;
+}
+
+bool	URPRLightComponent::NeedsTick() const
+{
+	return m_PropertiesDirty || ShouldPollProperties() || Super::NeedsTick();
+}
+
+void	URPRLightComponent::MarkPropertiesDirty()
+{
+	m_PropertiesDirty = true;
+	SetComponentTickEnabled(true);
+}
+
+void	URPRLightComponent::BindPropertyChangeEvents()
+{
+	check(IsInGameThread());
+
+	// One handler for all the lights, edits are dispatched through WatchedLights
+	if (!LightRenderStateDirtyHandle.IsValid())
+		LightRenderStateDirtyHandle = UActorComponent::MarkRenderStateDirtyEvent.AddStatic(&URPRLightComponent::OnSrcRenderStateDirty);
+#if WITH_EDITOR
+	if (!LightPropertyChangedHandle.IsValid())
+		LightPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddStatic(&URPRLightComponent::OnSrcPropertyChanged);
+#endif
+	{
+		FScopeLock	lock(&WatchedLightsLock);
+		WatchedLights.Add(SrcComponent, this);
+	}
+	MarkPropertiesDirty();
+}
+
+void	URPRLightComponent::UnbindPropertyChangeEvents()
+{
+	// Also released on the RPR thread
+	FScopeLock	lock(&WatchedLightsLock);
+	if (SrcComponent != NULL)
+	{
+		URPRLightComponent	**watcher = WatchedLights.Find(SrcComponent);
+		if (watcher != NULL && *watcher == this)
+			WatchedLights.Remove(SrcComponent);
+		return;
+	}
+	for (auto it = WatchedLights.CreateIterator(); it; ++it)
+	{
+		if (it->Value == this)
+			it.RemoveCurrent();
+	}
+}
+
+void	URPRLightComponent::OnSrcRenderStateDirty(UActorComponent &component)
+{
+	// Visibility toggles and mobility changes go through here
+	URPRLightComponent	*watcher = NULL;
+	{
+		FScopeLock	lock(&WatchedLightsLock);
+		URPRLightComponent	**found = WatchedLights.Find(&component);
+		if (found == NULL)
+			return;
+		watcher = *found;
+	}
+	watcher->MarkPropertiesDirty();
+}
+
+#if WITH_EDITOR
+void	URPRLightComponent::OnSrcPropertyChanged(UObject *object, FPropertyChangedEvent &propertyChangedEvent)
+{
+	UActorComponent	*component = Cast<UActorComponent>(object);
+	if (component != NULL)
+		OnSrcRenderStateDirty(*component);
+}
+#endif
+
 void	URPRLightComponent::ReleaseResources()
 {
+	UnbindPropertyChangeEvents();
 	if (m_RprLight != NULL)
 	{
 		check(Scene != NULL);
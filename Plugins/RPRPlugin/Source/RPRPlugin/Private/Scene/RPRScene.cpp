@@ -41,6 +41,7 @@
 #endif
 
 #include "Kismet/GameplayStatics.h"
+#include "Engine/Engine.h"
 #include "Camera/CameraActor.h"
 #include "Camera/CameraComponent.h"
 #include "Engine/Texture2DDynamic.h"
@@ -48,12 +49,16 @@
 
 #include "RPRStats.h"
 #include "Helpers/RPRHelpers.h"
+#include "Helpers/RPRTrace.h"
+#include "Helpers/RPRScratchMemory.h"
+#include "Constants/RPRConstants.h"
 #include "RenderingThread.h"
 #include "RPR_SDKModule.h"
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Components/StaticMeshComponent.h"
 #include "Helpers/ContextHelper.h"
 #include "RPRCoreModule.h"
+#include "HAL/IConsoleManager.h"
 
 #include <RadeonProRender.h>
 
@@ -64,12 +69,24 @@ DEFINE_LOG_CATEGORY_STATIC(LogRPRScene, Log, All);
 DEFINE_STAT(STAT_ProRender_UpdateScene);
 DEFINE_STAT(STAT_ProRender_CopyFramebuffer);
 
+static TAutoConsoleVariable<float> CVarRPRMotionSettleTime(
+	TEXT("RPR.Viewport.MotionSettleTime"),
+	0.2f,
+	TEXT("Seconds without viewport camera motion before rendering goes back to full resolution."));
+
+static TAutoConsoleVariable<float> CVarRPRDeletedSourcesSweepInterval(
+	TEXT("RPR.Scene.DeletedSourcesSweepInterval"),
+	2.0f,
+	TEXT("Seconds between two checks for source components destroyed without an actor deletion (components removed alone, streaming). 0 only relies on the deletion events."));
+
 
 ARPRScene::ARPRScene()
 	: m_RprScene(nullptr)
 	, m_ActiveCamera(nullptr)
 	, m_TriggerEndFrameResize(false)
 	, m_TriggerEndFrameRebuild(false)
+	, m_SourcesDeleted(false)
+	, m_LastDeletedSourcesSweep(0.0)
 	, m_RendererWorker(nullptr)
 	, m_Plugin(nullptr)
 	, m_RenderTexture(nullptr)
@@ -161,6 +178,20 @@ void	ARPRScene::SetQualitySettings(ERPRQualitySettings qualitySettings)
 	OnRender(m_Plugin->m_ObjectsToBuild);
 }
 
+void	ARPRScene::WakeRendererWorker()
+{
+	if (!m_RendererWorker.IsValid())
+		return;
+	m_RendererWorker->WakeUp();
+}
+
+void	ARPRScene::RequestPrepareUpdate()
+{
+	if (!m_RendererWorker.IsValid())
+		return;
+	m_RendererWorker->RequestPrepareUpdate();
+}
+
 void	ARPRScene::SetSamplingMinSPP()
 {
 	if (!m_RendererWorker.IsValid())
@@ -179,7 +210,7 @@ void	ARPRScene::ApplyDenoiser()
 {
 	if (!m_RendererWorker.IsValid())
 		return;
-	m_RendererWorker->ApplyDenoiser();
+	m_RendererWorker->RequestDenoise();
 }
 
 uint32	ARPRScene::GetRenderIteration() const
@@ -189,6 +220,16 @@ uint32	ARPRScene::GetRenderIteration() const
 	return m_RendererWorker->Iteration();
 }
 
+bool	ARPRScene::GetConvergence(float &outConvergedRatio, float &outSecondsLeft) const
+{
+	const URPRSettings	*settings = RPR::GetSettings();
+	if (!m_RendererWorker.IsValid() || settings->IsHybrid || !settings->EnableAdaptiveSampling)
+		return false;
+	outConvergedRatio = m_RendererWorker->ConvergedRatio();
+	outSecondsLeft = m_RendererWorker->EstimatedSecondsLeft();
+	return true;
+}
+
 bool ARPRScene::IsRPRSceneValid() const
 {
 	return m_RprScene != nullptr;
@@ -349,6 +390,7 @@ bool	ARPRScene::ResizeRenderTarget()
 	{
 		m_RenderTexture->Init(width, height, PF_R8G8B8A8, true);
 		m_RendererWorker->ResizeFramebuffer(m_RenderTexture->SizeX, m_RenderTexture->SizeY);
+		UpdateRegionOfInterest();
 	}
 	m_TriggerEndFrameResize = false;
 	return true;
@@ -399,6 +441,12 @@ void	ARPRScene::RefreshScene()
 bool	ARPRScene::RPRThread_Rebuild()
 {
 	bool			restartRender = false;
+
+	// Moving many actors at once only dirties transforms, they are converted together instead of one component at a time
+	FMemMark	mark(FMemStack::Get());
+	RPR::ScratchMemory::TScratchArray<RPR::FShape>	shapes;
+	RPR::ScratchMemory::TScratchArray<FTransform>	transforms;
+
 	for (int32 iObject = 0; iObject < SceneContent.Num(); ++iObject)
 	{
 		if (SceneContent[iObject] == nullptr ||
@@ -410,10 +458,28 @@ bool	ARPRScene::RPRThread_Rebuild()
 		URPRSceneComponent	*comp = Cast<URPRSceneComponent>(SceneContent[iObject]->GetRootComponent());
 		check(comp != nullptr);
 
+		comp->RPRThread_GatherShapeTransforms(shapes, transforms);
 		restartRender |= comp->RPRThread_Update();
 	}
 	if (ViewportCameraComponent != nullptr)
 		restartRender |= ViewportCameraComponent->RPRThread_Update();
+
+	if (shapes.Num() > 0)
+	{
+		RPR_TRACE_SCOPE("Update shape transforms");
+
+		RPR::ScratchMemory::TScratchArray<RadeonProRender::matrix>	matrices;
+		matrices.SetNumUninitialized(shapes.Num());
+		BuildMatricesWithScale(transforms, matrices, RPR::Constants::SceneTranslationScaleFromUE4ToRPR);
+
+		for (int32 iShape = 0; iShape < shapes.Num(); ++iShape)
+		{
+			const RPR::FResult	status = rprShapeSetTransform(shapes[iShape], RPR_TRUE, &matrices[iShape].m00);
+			if (RPR::IsResultFailed(status))
+				UE_LOG(LogRPRScene, Warning, TEXT("Couldn't refresh RPR mesh transform (%d)"), status);
+		}
+		restartRender = true;
+	}
 	return restartRender;
 }
 
@@ -483,6 +549,7 @@ void	ARPRScene::OnRender(uint32 &outObjectToBuildCount)
 		if (RPR::GetSettings()->IsHybrid)
 			m_RendererWorker->SetQualitySettings(settings->QualitySettings);
 		m_RendererWorker->SetAOV(m_Plugin->GetAOV());
+		UpdateRegionOfInterest();
 	}
 	m_RendererWorker->SetPaused(false);
 }
@@ -508,6 +575,14 @@ void	ARPRScene::InitializeRPRRendering()
 	}
 
 	m_RenderTexture = m_Plugin->GetRenderTexture();
+
+	// Idle components don't tick, their removal is driven by these events
+	if (GEngine != nullptr && !m_LevelActorDeletedHandle.IsValid())
+		m_LevelActorDeletedHandle = GEngine->OnLevelActorDeleted().AddUObject(this, &ARPRScene::OnLevelActorDeleted);
+#if WITH_EDITOR
+	if (!m_ObjectsReplacedHandle.IsValid())
+		m_ObjectsReplacedHandle = FCoreUObjectDelegates::OnObjectsReplaced.AddUObject(this, &ARPRScene::OnObjectsReplaced);
+#endif
 }
 
 void	ARPRScene::Rebuild()
@@ -524,6 +599,7 @@ void	ARPRScene::Rebuild()
 
 	RPRCoreResources->GetRPRMaterialLibrary().ClearCache();
 	RPRCoreResources->GetRPRImageManager()->ClearCache();
+	URPRLightComponent::ClearIESCache();
 
 	RPR::FResult result = RPR::Context::ClearMemory(RPRCoreResources->GetRPRContext());
 	if (RPR::IsResultFailed(result))
@@ -556,6 +632,39 @@ void	ARPRScene::SetOrbit(bool orbit)
 	}
 }
 
+/*
+* The plugin keeps the region of interest normalized so that it survives render target resizes,
+* the renderer works in framebuffer pixels.
+*/
+void	ARPRScene::UpdateRegionOfInterest()
+{
+	if (!m_RendererWorker.IsValid() ||
+		m_RenderTexture == nullptr)
+		return;
+
+	const FBox2D	&region = m_Plugin->GetRegionOfInterest();
+	FIntRect		pixelRegion;
+	if (region.bIsValid)
+	{
+		const int32	width = m_RenderTexture->SizeX;
+		const int32	height = m_RenderTexture->SizeY;
+		pixelRegion = FIntRect(
+			FMath::FloorToInt(region.Min.X * width), FMath::FloorToInt(region.Min.Y * height),
+			FMath::CeilToInt(region.Max.X * width), FMath::CeilToInt(region.Max.Y * height));
+	}
+	m_RendererWorker->SetRegionOfInterest(pixelRegion);
+}
+
+void	ARPRScene::ExportToGLTF(const FString &filename, TFunction<void(bool)> onCompleted)
+{
+	if (!m_RendererWorker.IsValid())
+	{
+		onCompleted(false);
+		return;
+	}
+	m_RendererWorker->ExportToGLTF(filename, MoveTemp(onCompleted));
+}
+
 void	ARPRScene::SetAOV(RPR::EAOV AOV)
 {
 	if (m_RendererWorker.IsValid())
@@ -673,6 +782,70 @@ void	ARPRScene::OnSave()
 	}
 }
 
+/*
+* Renders the current state of the scene until the iteration ceiling or the noise threshold is reached, then writes it to disk.
+* Used when there is no viewport to drive the Tick (commandlets). The RPR scene stays resident between calls,
+* only the components flagged dirty since the previous frame are updated.
+*/
+bool	ARPRScene::RenderOfflineFrame(const FString &filename, float timeoutSeconds)
+{
+	check(IsInGameThread());
+
+	if (!m_RendererWorker.IsValid())
+		return false;
+
+	const double	deadline = FPlatformTime::Seconds() + timeoutSeconds;
+
+	// Wait for the queued actors to be built and post built
+	while (BuildQueue.Num() > 0 || m_RendererWorker->IsBuildingObjects())
+	{
+		CheckPendingKills();
+		m_RendererWorker->SyncQueue(BuildQueue, SceneContent);
+		if (FPlatformTime::Seconds() > deadline)
+		{
+			UE_LOG(LogRPRScene, Error, TEXT("Timed out while building the scene for '%s'"), *filename);
+			return false;
+		}
+		FPlatformProcess::Sleep(0.01f);
+	}
+	CheckPendingKills();
+
+	ResizeRenderTarget();
+
+	while (!m_RendererWorker->RestartRender()) // Fails until the framebuffers are created
+	{
+		if (FPlatformTime::Seconds() > deadline)
+		{
+			UE_LOG(LogRPRScene, Error, TEXT("Timed out while creating the framebuffers for '%s'"), *filename);
+			return false;
+		}
+		FPlatformProcess::Sleep(0.001f);
+	}
+	m_TriggerEndFrameRebuild = false;
+
+	while (!m_RendererWorker->IsRenderingFinished())
+	{
+		if (FPlatformTime::Seconds() > deadline)
+		{
+			UE_LOG(LogRPRScene, Error, TEXT("Timed out while rendering '%s' (%d iterations done)"), *filename, m_RendererWorker->Iteration());
+			return false;
+		}
+		FPlatformProcess::Sleep(0.01f);
+	}
+
+	TFuture<bool>	saved = m_RendererWorker->SaveRenderData(filename);
+	if (!saved.WaitFor(FTimespan::FromSeconds(FMath::Max(deadline - FPlatformTime::Seconds(), 0.0))))
+	{
+		UE_LOG(LogRPRScene, Error, TEXT("Timed out while saving '%s'"), *filename);
+		return false;
+	}
+	if (!saved.Get())
+		return false;
+
+	UE_LOG(LogRPRScene, Log, TEXT("Saved '%s' (%d iterations)"), *filename, m_RendererWorker->Iteration());
+	return true;
+}
+
 void	ARPRScene::CheckPendingKills()
 {
 	const bool	canSafelyKill = !m_RendererWorker.IsValid();
@@ -695,9 +868,46 @@ void	ARPRScene::CheckPendingKills()
 	}
 }
 
+void	ARPRScene::OnLevelActorDeleted(AActor *actor)
+{
+	// Our own actors go through RemoveActor
+	if (Cast<ARPRActor>(actor) == nullptr)
+		m_SourcesDeleted = true;
+}
+
+#if WITH_EDITOR
+void	ARPRScene::OnObjectsReplaced(const TMap<UObject*, UObject*> &replacementMap)
+{
+	// Blueprint recompiles replace the source components
+	m_SourcesDeleted = true;
+}
+#endif
+
+void	ARPRScene::RemoveDeletedSources()
+{
+	// Idle components don't tick, so they can't notice their source went away.
+	// Walked after a deletion event, otherwise at the sweep interval for sources destroyed without one
+	const double	now = FPlatformTime::Seconds();
+	const float		sweepInterval = CVarRPRDeletedSourcesSweepInterval.GetValueOnGameThread();
+	if (!m_SourcesDeleted && (sweepInterval <= 0.0f || now - m_LastDeletedSourcesSweep < sweepInterval))
+		return;
+	m_SourcesDeleted = false;
+	m_LastDeletedSourcesSweep = now;
+
+	for (int32 iObject = SceneContent.Num() - 1; iObject >= 0; --iObject)
+	{
+		ARPRActor	*actor = SceneContent[iObject];
+		if (actor != nullptr &&
+			actor->Component != nullptr &&
+			!actor->Component->IsSrcComponentValid())
+			RemoveActor(actor);
+	}
+}
+
 void	ARPRScene::Tick(float deltaTime)
 {
 	SCOPE_CYCLE_COUNTER(STAT_ProRender_UpdateScene);
+	RPR_TRACE_SCOPE("Update scene");
 	if (!m_RendererWorker.IsValid() ||
 		m_RenderTexture == nullptr ||
 		m_RenderTexture->Resource == nullptr ||
@@ -708,6 +918,7 @@ void	ARPRScene::Tick(float deltaTime)
 		return;
 
 	CheckPendingKills();
+	RemoveDeletedSources();
 
 	// First, launch build of queued actors on the RPR thread
 	const uint32	actorCount = SceneContent.Num();
@@ -728,10 +939,17 @@ void	ARPRScene::Tick(float deltaTime)
 		ResizeRenderTarget();
 	}
 
+	// Navigate at a reduced resolution, refine once the viewport camera settles
+	const bool	isCameraMoving =
+		m_ActiveCamera != nullptr &&
+		m_ActiveCamera == ViewportCameraComponent &&
+		FPlatformTime::Seconds() - ViewportCameraComponent->GetLastMoveTime() < CVarRPRMotionSettleTime.GetValueOnGameThread();
+	m_RendererWorker->SetInteractivePreview(isCameraMoving);
+
 	if (m_TriggerEndFrameRebuild)
 	{
 		// Restart render, skip frame copy
-		if (m_RendererWorker->RestartRender()) // Trylock, might fail
+		if (m_RendererWorker->RestartRender()) // Fails until the framebuffers are created
 		{
 			m_TriggerEndFrameRebuild = false;
 		}
@@ -751,44 +969,47 @@ void ARPRScene::DrawRPRBufferToViewport()
 void ARPRScene::CopyRPRRenderBufferToViewportRenderTexture()
 {
 	SCOPE_CYCLE_COUNTER(STAT_ProRender_CopyFramebuffer);
+	RPR_TRACE_SCOPE("Copy framebuffer");
 
 	m_RendererWorker->m_DataLock.Lock();
-	const uint8	*textureData = m_RendererWorker->GetFramebufferData();
+	const uint8		*textureData = m_RendererWorker->GetFramebufferData();
+	const FIntRect	dirtyRegion = m_RendererWorker->ConsumeDirtyRegion();
+	if (dirtyRegion.Area() <= 0)
+	{
+		m_RendererWorker->m_DataLock.Unlock();
+		return;
+	}
+
+	// Only upload what the renderer wrote since last frame (the region of interest when there is one)
+	FUpdateTextureRegion2D	region;
+	region.SrcX   = 0;
+	region.SrcY   = 0;
+	region.DestX  = dirtyRegion.Min.X;
+	region.DestY  = dirtyRegion.Min.Y;
+	region.Width  = dirtyRegion.Width();
+	region.Height = dirtyRegion.Height();
+
+	const uint32	pitch = m_RenderTexture->SizeX * sizeof(uint8) * 4;
+	const uint8		*regionData = textureData + dirtyRegion.Min.Y * pitch + dirtyRegion.Min.X * sizeof(uint8) * 4;
 #if  ENGINE_MINOR_VERSION >= 24
 	ENQUEUE_RENDER_COMMAND(UpdateDynamicTextureCode) (
-		[this, textureData](FRHICommandListImmediate& RHICmdList)
+		[this, region, pitch, regionData](FRHICommandListImmediate& RHICmdList)
 		{
-			FUpdateTextureRegion2D	region;
-			region.SrcX   = 0;
-			region.SrcY   = 0;
-			region.DestX  = 0;
-			region.DestY  = 0;
-			region.Width  = m_RenderTexture->SizeX;
-			region.Height = m_RenderTexture->SizeY;
-
-			const uint32 pitch = region.Width * sizeof(uint8) * 4;
 			FRHITexture2D	*resource = (FRHITexture2D*)m_RenderTexture->Resource->TextureRHI.GetReference();
 
-			RHIUpdateTexture2D(resource, 0, region, pitch, textureData);
+			RHIUpdateTexture2D(resource, 0, region, pitch, regionData);
 		}
 	); // ENQUEUE_RENDER_COMMAND
 #else
-	ENQUEUE_UNIQUE_RENDER_COMMAND_TWOPARAMETER(
+	ENQUEUE_UNIQUE_RENDER_COMMAND_FOURPARAMETER(
 		UpdateDynamicTextureCode,
 		UTexture2DDynamic*, renderTexture, m_RenderTexture,
-		const uint8*, textureData, textureData,
+		FUpdateTextureRegion2D, region, region,
+		uint32, pitch, pitch,
+		const uint8*, regionData, regionData,
 		{
-			FUpdateTextureRegion2D	region;
-			region.SrcX = 0;
-			region.SrcY = 0;
-			region.DestX = 0;
-			region.DestY = 0;
-			region.Width = renderTexture->SizeX;
-			region.Height = renderTexture->SizeY;
-
-			const uint32	pitch = region.Width * sizeof(uint8) * 4;
 			FRHITexture2D	*resource = (FRHITexture2D*)renderTexture->Resource->TextureRHI.GetReference();
-			RHIUpdateTexture2D(resource, 0, region, pitch, textureData);
+			RHIUpdateTexture2D(resource, 0, region, pitch, regionData);
 		}
 	);
 #endif
@@ -819,6 +1040,7 @@ void	ARPRScene::RemoveSceneContent(bool clearScene, bool clearCache)
 		if (clearCache)
 		{
 			RPRCoreResources->GetRPRMaterialLibrary().ClearCache();
+			URPRLightComponent::ClearIESCache();
 
 			try
 			{
@@ -885,6 +1107,14 @@ void	ARPRScene::BeginDestroy()
 {
 	Super::BeginDestroy();
 
+	if (m_LevelActorDeletedHandle.IsValid() && GEngine != nullptr)
+		GEngine->OnLevelActorDeleted().Remove(m_LevelActorDeletedHandle);
+	m_LevelActorDeletedHandle.Reset();
+#if WITH_EDITOR
+	FCoreUObjectDelegates::OnObjectsReplaced.Remove(m_ObjectsReplacedHandle);
+	m_ObjectsReplacedHandle.Reset();
+#endif
+
 	if (m_RendererWorker.IsValid())
 	{
 		m_RendererWorker->EnsureCompletion();
@@ -22,12 +22,21 @@
 #include "Scene/RPRActor.h"
 #include "Scene/RPRScene.h"
 
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarRPRPollTransforms(
+	TEXT("RPR.Sync.PollTransforms"),
+	0,
+	TEXT("Also compare every RPR component transform against its source each tick.\n")
+	TEXT("Only needed when source components are moved without broadcasting TransformUpdated (ie. SetComponentToWorld)."));
+
 URPRSceneComponent::URPRSceneComponent()
 :	Scene(NULL)
 ,	m_Built(false)
 ,	m_Sync(true)
 ,	m_Plugin(NULL)
 ,	m_RebuildFlags(0)
+,	m_SrcTransformChanged(false)
 {
 	PrimaryComponentTick.bCanEverTick = true;
 	bTickInEditor = true;
@@ -39,10 +48,29 @@ bool	URPRSceneComponent::PostBuild()
 
 	check(SrcComponent != NULL);
 	m_CachedTransforms = SrcComponent->GetComponentToWorld();
+	if (!m_TransformUpdatedHandle.IsValid())
+		m_TransformUpdatedHandle = SrcComponent->TransformUpdated.AddUObject(this, &URPRSceneComponent::OnSrcTransformUpdated);
 	m_Built = true;
 	return true;
 }
 
+void	URPRSceneComponent::OnSrcTransformUpdated(USceneComponent *updatedComponent, EUpdateTransformFlags updateTransformFlags, ETeleportType teleport)
+{
+	// Picked up on the next tick, so that changes done while sync is disabled are not lost
+	if (!m_SrcTransformChanged.AtomicSet(true))
+		SetComponentTickEnabledAsync(true);
+}
+
+void	URPRSceneComponent::UnbindSrcComponentEvents()
+{
+	if (m_TransformUpdatedHandle.IsValid())
+	{
+		if (SrcComponent != NULL)
+			SrcComponent->TransformUpdated.Remove(m_TransformUpdatedHandle);
+		m_TransformUpdatedHandle.Reset();
+	}
+}
+
 bool	URPRSceneComponent::IsSrcComponentValid() const
 {
 	return SrcComponent != NULL &&
@@ -70,6 +98,24 @@ void	URPRSceneComponent::TriggerRebuildTransforms()
 	m_RefreshLock.Lock();
 	m_RebuildFlags |= PROPERTY_REBUILD_TRANSFORMS;
 	m_RefreshLock.Unlock();
+	WakeRenderer();
+}
+
+void	URPRSceneComponent::WakeRenderer()
+{
+	if (Scene != nullptr)
+		Scene->WakeRendererWorker();
+}
+
+void	URPRSceneComponent::RequestPrepareUpdate()
+{
+	if (Scene != nullptr)
+		Scene->RequestPrepareUpdate();
+}
+
+bool	URPRSceneComponent::NeedsTick() const
+{
+	return m_SrcTransformChanged || CVarRPRPollTransforms.GetValueOnGameThread() != 0;
 }
 
 void	URPRSceneComponent::TickComponent(float deltaTime, ELevelTick tickType, FActorComponentTickFunction *tickFunction)
@@ -83,30 +129,36 @@ void	URPRSceneComponent::TickComponent(float deltaTime, ELevelTick tickType, FAc
 	{
 		// Source object destroyed, remove ourselves
 		Scene->RemoveActor(Cast<ARPRActor>(GetOwner()));
+		SetComponentTickEnabled(false);
 		return;
 	}
-	if (!m_Sync)
-		return;
 	check(m_Plugin != NULL);
 	URPRSettings	*settings = GetMutableDefault<URPRSettings>();
 	check(settings != NULL);
 
-	if (!settings->bSync)
-		return;
-	// Seem to be the only way..
-	// There is no runtime enabled callbacks
-	// UEngine::OnActorMoved() and UEngine::OnComponentTransformChanged() are editor only..
-	m_RefreshLock.Lock();
-	if (!m_CachedTransforms.Equals(SrcComponent->GetComponentToWorld(), 0.0001f))
+	// Moves are notified by TransformUpdated, untouched components stop here
+	const bool	pollTransforms = CVarRPRPollTransforms.GetValueOnGameThread() != 0;
+	if (m_Sync && settings->bSync && (m_SrcTransformChanged || pollTransforms))
 	{
-		m_RebuildFlags |= PROPERTY_REBUILD_TRANSFORMS;
-		m_CachedTransforms = SrcComponent->GetComponentToWorld();
+		m_RefreshLock.Lock();
+		m_SrcTransformChanged = false;
+		if (!m_CachedTransforms.Equals(SrcComponent->GetComponentToWorld(), 0.0001f))
+		{
+			m_RebuildFlags |= PROPERTY_REBUILD_TRANSFORMS;
+			m_CachedTransforms = SrcComponent->GetComponentToWorld();
+			WakeRenderer();
+		}
+		m_RefreshLock.Unlock();
 	}
-	m_RefreshLock.Unlock();
+
+	// Switched back on by the change events, a pending change keeps it ticking while sync is disabled
+	if (!NeedsTick())
+		SetComponentTickEnabled(false);
 }
 
 void	URPRSceneComponent::ReleaseResources()
 {
+	UnbindSrcComponentEvents();
 	m_Built = false;
 }
 
@@ -114,6 +166,7 @@ void	URPRSceneComponent::BeginDestroy()
 {
 	Super::BeginDestroy();
 
+	UnbindSrcComponentEvents();
 	if (m_Built)
 	{
 		// Object deleted before the scene has been destroyed
@@ -27,9 +27,14 @@
 #include "Components/InstancedStaticMeshComponent.h"
 #include "Rendering/PositionVertexBuffer.h"
 #include "StaticMeshResources.h"
+#include "Materials/MaterialInstance.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
 
 #include "Helpers/RPRHelpers.h"
 #include "Helpers/RPRShapeHelpers.h"
+#include "Helpers/RPRTrace.h"
+#include "Helpers/RPRScratchMemory.h"
 
 #include "RPRStats.h"
 #include "Scene/RPRScene.h"
@@ -64,9 +69,44 @@ DEFINE_STAT(STAT_ProRender_UpdateMeshes);
 
 TMap<UStaticMesh*, TArray<FRPRCachedMesh>>	URPRStaticMeshComponent::Cache;
 
+FCriticalSection												URPRStaticMeshComponent::MaterialUsersLock;
+TMultiMap<const UMaterialInterface*, URPRStaticMeshComponent*>	URPRStaticMeshComponent::MaterialUsers;
+TMap<const UActorComponent*, URPRStaticMeshComponent*>			URPRStaticMeshComponent::WatchedSrcComponents;
+
+static FDelegateHandle	RenderStateDirtyHandle;
+#if WITH_EDITOR
+static FDelegateHandle	ObjectPropertyChangedHandle;
+#endif
+
+static TAutoConsoleVariable<int32> CVarRPRPollMaterials(
+	TEXT("RPR.Sync.PollMaterials"),
+	0,
+	TEXT("Also compare every RPR mesh material slot against its source each tick.\n")
+	TEXT("Only needed when materials are assigned without marking the render state dirty."));
+
 static bool const FLIP_SURFACE_NORMALS = false;
 static bool const FLIP_UV_Y            = true;
 
+namespace
+{
+	// Keys are hashed on their bits: -0 would never merge with 0
+	float		WeldComponent(float Value) { return Value == 0.0f ? 0.0f : Value; }
+	FVector		WeldKey(const FVector& Value) { return FVector(WeldComponent(Value.X), WeldComponent(Value.Y), WeldComponent(Value.Z)); }
+	FVector2D	WeldKey(const FVector2D& Value) { return FVector2D(WeldComponent(Value.X), WeldComponent(Value.Y)); }
+
+	template<typename TValue, typename TIds, typename TValues>
+	uint32	WeldAttribute(TIds& Ids, TValues& Values, const TValue& Value)
+	{
+		const TValue	key = WeldKey(Value);
+		if (const uint32* id = Ids.Find(key))
+			return *id;
+
+		const uint32	id = Values.Add(key);
+		Ids.Add(key, id);
+		return id;
+	}
+}
+
 
 URPRStaticMeshComponent::URPRStaticMeshComponent()
 {
@@ -110,90 +150,87 @@ void	URPRStaticMeshComponent::ClearCache(RPR::FScene scene)
 
 bool	URPRStaticMeshComponent::BuildMaterials()
 {
-	RPR::FResult status;
-	FRPRXMaterialLibrary	&rprMaterialLibrary = IRPRCore::GetResources()->GetRPRMaterialLibrary();
-
 	const UStaticMeshComponent	*component = Cast<UStaticMeshComponent>(SrcComponent);
 	check(component != nullptr);
 
 	// Assign the materials on the instances: The cached geometry might be the same
 	// But materials can be overriden on a component basis
+	TMap<int32, FRPRPreparedMaterial>	slotMaterials;
 	const uint32	shapeCount = m_Shapes.Num();
 	for (uint32 iShape = 0; iShape < shapeCount; ++iShape)
 	{
-		rpr_shape	shape = m_Shapes[iShape].m_RprShape;
-		status = RPR_SUCCESS;
-
 		// If we have a wrong index, it will just return nullptr, and fallback to a dummy material
-		UMaterialInterface	*matInterface = component->GetMaterial(m_Shapes[iShape].m_UEMaterialIndex);
-
-		if (matInterface != nullptr && matInterface->IsA<URPRMaterial>())
-		{
-			URPRMaterial	*rprMaterial = Cast<URPRMaterial>(matInterface);
-			BuildRPRMaterial(shape, rprMaterial);
-
-			RPR::FRPRXMaterialPtr	rprxMaterial = rprMaterialLibrary.GetMaterial(rprMaterial);
-			m_Shapes[iShape].m_RprxMaterial = rprxMaterial;
-		}
-		else if (matInterface)
-		{
-			URadeonMaterialParser parser;
-			parser.Process(m_Shapes[iShape], matInterface);
-		}
-		else
-		{
-			AttachDummyMaterial(shape);
-		}
+		const int32			materialIndex = m_Shapes[iShape].m_UEMaterialIndex;
+		UMaterialInterface	*matInterface = component->GetMaterial(materialIndex);
+
+		URPRMaterial	*rprMaterial = Cast<URPRMaterial>(matInterface);
+		if (rprMaterial != nullptr)
+			m_OnMaterialChangedDelegateHandles.Subscribe(rprMaterial);
+
+		// Shapes sharing a slot share its material, parse it once
+		const FRPRPreparedMaterial	*material = slotMaterials.Find(materialIndex);
+		if (material == nullptr)
+			material = &slotMaterials.Add(materialIndex, PrepareMaterial(matInterface));
+		BindMaterialOnShape(m_Shapes[iShape], *material);
 	}
 
-	UpdateLastMaterialList();
-	m_cachedMaterials = m_lastMaterialsList;
+	const int32	numMaterials = component->GetNumMaterials();
+	m_cachedMaterials.SetNum(numMaterials);
+	for (int32 materialIndex = 0; materialIndex < numMaterials; ++materialIndex)
+		m_cachedMaterials[materialIndex] = component->GetMaterial(materialIndex);
 
 	return true;
 }
 
-void URPRStaticMeshComponent::BuildRPRMaterial(RPR::FShape& Shape, URPRMaterial* Material)
+FRPRPreparedMaterial URPRStaticMeshComponent::PrepareMaterial(UMaterialInterface* Material)
 {
+	check(IsInGameThread());
+
 	FRPRXMaterialLibrary& rprMaterialLibrary = IRPRCore::GetResources()->GetRPRMaterialLibrary();
+	FRPRPreparedMaterial prepared;
 
-	if (!rprMaterialLibrary.Contains(Material))
+	URPRMaterial* rprMaterial = Cast<URPRMaterial>(Material);
+	if (rprMaterial != nullptr)
 	{
-		rprMaterialLibrary.CacheAndRegisterMaterial(Material);
+		if (!rprMaterialLibrary.Contains(rprMaterial))
+		{
+			rprMaterialLibrary.CacheAndRegisterMaterial(rprMaterial);
+		}
+		else if (rprMaterial->IsMaterialDirty())
+		{
+			rprMaterialLibrary.RecacheMaterial(rprMaterial);
+		}
+
+		if (rprMaterialLibrary.TryGetMaterial(rprMaterial, prepared.RprxMaterial))
+			prepared.RawMaterial = prepared.RprxMaterial->GetRawMaterial();
+		else
+			UE_LOG(LogRPRStaticMeshComponent, Error, TEXT("Cannot get the material raw datas from the library."));
 	}
-	else if (Material->IsMaterialDirty())
+	else if (Material != nullptr)
 	{
-		rprMaterialLibrary.RecacheMaterial(Material);
+		// Materials the parser can't convert are left detached, don't keep a previous slot material bound
+		URadeonMaterialParser parser;
+		prepared.RprxNodeMaterial = parser.Parse(Material);
+		if (prepared.RprxNodeMaterial.IsValid())
+			prepared.RawMaterial = prepared.RprxNodeMaterial->GetRawMaterial();
 	}
-
-	m_OnMaterialChangedDelegateHandles.Subscribe(Material);
-
-	ApplyRPRMaterialOnShape(Shape, Material);
-}
-
-bool URPRStaticMeshComponent::ApplyRPRMaterialOnShape(RPR::FShape& Shape, URPRMaterial* Material)
-{
-	FRPRXMaterialLibrary& rprMaterialLibrary = IRPRCore::GetResources()->GetRPRMaterialLibrary();
-
-	RPR::FRPRXMaterialPtr rprxMaterial;
-	if (!rprMaterialLibrary.TryGetMaterial(Material, rprxMaterial))
+	else
 	{
-		UE_LOG(LogRPRStaticMeshComponent, Error, TEXT("Cannot get the material raw datas from the library."));
-		return (false);
+		prepared.RawMaterial = rprMaterialLibrary.GetDummyMaterial();
 	}
 
-	rpr_int status = rprShapeSetMaterial(Shape, rprxMaterial->GetRawMaterial());
-	return (RPR::IsResultSuccess(status));
+	return prepared;
 }
 
-void URPRStaticMeshComponent::AttachDummyMaterial(RPR::FShape shape)
+void URPRStaticMeshComponent::BindMaterialOnShape(FRPRShape& Shape, const FRPRPreparedMaterial& Material)
 {
-	FRPRXMaterialLibrary& rprMaterialLibrary = IRPRCore::GetResources()->GetRPRMaterialLibrary();
-	RPR::FMaterialNode dummyMaterial = rprMaterialLibrary.GetDummyMaterial();
+	Shape.m_RprxMaterial = Material.RprxMaterial;
+	Shape.m_RprxNodeMaterial = Material.RprxNodeMaterial;
 
-	RPR::FResult result = RPR::Shape::SetMaterial(shape, dummyMaterial);
+	RPR::FResult result = RPR::Shape::SetMaterial(Shape.m_RprShape, Material.RawMaterial);
 	if (RPR::IsResultFailed(result))
 	{
-		UE_LOG(LogRPRStaticMeshComponent, Warning, TEXT("Cannot attach dummy material to mesh %s"), *GetName());
+		UE_LOG(LogRPRStaticMeshComponent, Warning, TEXT("Cannot attach material to mesh %s"), *GetName());
 	}
 }
 
@@ -258,60 +295,86 @@ bool	URPRStaticMeshComponent::Build()
 		const uint32				srcIndexStart = section.FirstIndex;
 		const uint32				indexCount = section.NumTriangles * 3;
 
-		TArray<FVector>		positions;
-		TArray<FVector>		normals;
-		TArray<FVector2D>	uvs;
-
 		const uint32	vertexCount = (section.MaxVertexIndex - section.MinVertexIndex) + 1;
 		if (vertexCount == 0)
 			continue;
 
-		// Lots of resizing ..
-		positions.SetNum(vertexCount);
-		normals.SetNum(vertexCount);
-		if (uvCount > 0) // For now force set only one uv set
-			uvs.SetNum(vertexCount * 1/*uvCount*/);
+		// Section buffers are only needed until rprContextCreateMesh copies them
+		FMemMark	mark(FMemStack::Get());
 
-		TArray<uint32>	indices;
-		TArray<uint32>	numFaceVertices;
+		RPR::ScratchMemory::TScratchArray<FVector>		positions;
+		RPR::ScratchMemory::TScratchArray<FVector>		normals;
+		RPR::ScratchMemory::TScratchArray<FVector2D>	uvs;
 
-		indices.SetNum(indexCount);
-		numFaceVertices.SetNum(section.NumTriangles);
+		RPR::ScratchMemory::TScratchArray<uint32>	positionIndices;
+		RPR::ScratchMemory::TScratchArray<uint32>	normalIndices;
+		RPR::ScratchMemory::TScratchArray<uint32>	uvIndices;
+		RPR::ScratchMemory::TScratchArray<uint32>	numFaceVertices;
+
+		// Welded ids of each vertex of the section range, converted the first time an index references it
+		RPR::ScratchMemory::TScratchArray<FIntVector>	vertexIds;
+		vertexIds.Init(FIntVector(INDEX_NONE), vertexCount);
+
+		// Welding never produces more values than the section range, so the scratch arrays never grow
+		positions.Reserve(vertexCount);
+		normals.Reserve(vertexCount);
+		if (uvCount > 0)
+			uvs.Reserve(vertexCount);
+
+		positionIndices.SetNumUninitialized(indexCount);
+		normalIndices.SetNumUninitialized(indexCount);
+		if (uvCount > 0) // For now force set only one uv set
+			uvIndices.SetNumUninitialized(indexCount);
+		numFaceVertices.Init(3, section.NumTriangles);
+
+		// UE splits vertices on normal and uv seams, RPR takes an index stream per attribute so each one is welded on its own
+		RPR::ScratchMemory::TScratchMap<FVector, uint32>	positionIds;
+		RPR::ScratchMemory::TScratchMap<FVector, uint32>	normalIds;
+		RPR::ScratchMemory::TScratchMap<FVector2D, uint32>	uvIds;
+		positionIds.Reserve(vertexCount);
+		normalIds.Reserve(vertexCount);
+		if (uvCount > 0)
+			uvIds.Reserve(vertexCount);
 
 		const uint32	offset = section.MinVertexIndex;
 		for (uint32 iIndex = 0; iIndex < indexCount; ++iIndex)
 		{
 			const uint32	index = srcIndices[srcIndexStart + iIndex];
-			const uint32	remappedIndex = index - offset;
-
-			indices[iIndex] = remappedIndex;
+			FIntVector&		ids = vertexIds[index - offset];
 
-			FVector	pos = srcPositions.VertexPosition(index) * RPR::Constants::SceneTranslationScaleFromUE4ToRPR;
-			FVector	normal = srcVertices.VertexTangentZ(index);
-			positions[remappedIndex] = FVector(pos.X, pos.Z, pos.Y);
-			if (FLIP_SURFACE_NORMALS)
+			if (ids.X == INDEX_NONE)
 			{
-				normal = -normal;
-			}
-			normals[remappedIndex] = FVector(normal.X, normal.Z, normal.Y);
+				FVector	pos = srcPositions.VertexPosition(index) * RPR::Constants::SceneTranslationScaleFromUE4ToRPR;
+				FVector	normal = srcVertices.VertexTangentZ(index);
+				if (FLIP_SURFACE_NORMALS)
+				{
+					normal = -normal;
+				}
+				ids.X = WeldAttribute(positionIds, positions, FVector(pos.X, pos.Z, pos.Y));
+				ids.Y = WeldAttribute(normalIds, normals, FVector(normal.X, normal.Z, normal.Y));
 
-			if (uvCount > 0)
-			{
-				FVector2D uv = srcVertices.GetVertexUV(index, 0); // Right now only copy uv 0
-				if (FLIP_UV_Y)
+				if (uvCount > 0)
 				{
-					uv.Y = 1 - uv.Y;
+					FVector2D uv = srcVertices.GetVertexUV(index, 0); // Right now only copy uv 0
+					if (FLIP_UV_Y)
+					{
+						uv.Y = 1 - uv.Y;
+					}
+					ids.Z = WeldAttribute(uvIds, uvs, uv);
 				}
-				uvs[remappedIndex] = uv;
 			}
-		}
 
-		for (uint32 iTriangle = 0; iTriangle < section.NumTriangles; ++iTriangle)
-			numFaceVertices[iTriangle] = 3;
+			positionIndices[iIndex] = ids.X;
+			normalIndices[iIndex] = ids.Y;
+			if (uvCount > 0)
+				uvIndices[iIndex] = ids.Z;
+		}
+		RPR::ScratchMemory::TrackUsage();
 
 		rpr_shape	baseShape;
-		status = RPR::Context::CreateMesh(rprContext, *staticMesh->GetName(), positions, normals, indices, uvs, numFaceVertices, baseShape);
-		CHECK_ERROR(status, TEXT("Couldn't create RPR static mesh from '%s', section %d. Num indices = %d, Num vertices = %d"), *SrcComponent->GetName(), iSection, indices.Num(), positions.Num());
+		status = RPR::Context::CreateMesh(rprContext, *staticMesh->GetName(),
+			positions, positionIndices, normals, normalIndices, uvs, uvIndices, numFaceVertices, baseShape);
+		CHECK_ERROR(status, TEXT("Couldn't create RPR static mesh from '%s', section %d. Num indices = %d, Num vertices = %d"), *SrcComponent->GetName(), iSection, positionIndices.Num(), positions.Num());
 
 		FRPRCachedMesh	newShape(baseShape, section.MaterialIndex);
 		if (!Cache.Contains(staticMesh))
@@ -332,16 +395,14 @@ bool	URPRStaticMeshComponent::Build()
 		for (uint32 iInstance = 0; iInstance < instanceCount; ++iInstance)
 		{
 			FRPRCachedMesh	newInstance(newShape.m_UEMaterialIndex);
-			status = rprContextCreateInstance(rprContext, baseShape, &newInstance.m_RprShape);
+			const FString	instanceName = iInstance + 1 < instanceCount ?
+				FString::Printf(TEXT("%s_%d"), *SrcComponent->GetOwner()->GetName(), iInstance) :
+				SrcComponent->GetOwner()->GetName();
+
+			status = RPR::Context::CreateInstance(rprContext, baseShape, instanceName, newInstance.m_RprShape);
 			CHECK_ERROR(status, TEXT("Couldn't create RPR static mesh instance from '%s'"), *staticMesh->GetName());
 
 			m_Shapes.Add(FRPRShape(newInstance, iInstance));
-
-			// Set shape name
-			if (iInstance + 1 < instanceCount)
-				RPR::SetObjectName(newInstance.m_RprShape, *FString::Printf(TEXT("%s_%d"), *SrcComponent->GetOwner()->GetName(), iInstance));
-			else
-				RPR::SetObjectName(newInstance.m_RprShape, *FString::Printf(TEXT("%s"), *SrcComponent->GetOwner()->GetName()));
 		}
 	} // end of cycle
 
@@ -405,10 +466,40 @@ bool	URPRStaticMeshComponent::PostBuild()
 		if (!BuildMaterials())
 			return false;
 	}
+	WatchMaterials();
 
 	return Super::PostBuild();
 }
 
+void	URPRStaticMeshComponent::PrepareUpdate()
+{
+	check(IsInGameThread());
+
+	// Slot changes keep coming in while the materials are parsed, only hold the lock to take them
+	TMap<int32, TWeakObjectPtr<UMaterialInterface>> dirtySlots;
+	{
+		FScopeLock sc(&m_RefreshLock);
+		Swap(dirtySlots, m_DirtyMaterialSlots);
+	}
+
+	// The source can be deleted (and brought back by an undo) while slots are pending,
+	// it gets a new RPR component in that case
+	if (dirtySlots.Num() == 0 || !IsSrcComponentValid())
+		return;
+
+	TMap<int32, FRPRPreparedMaterial> preparedSlots;
+	for (const TPair<int32, TWeakObjectPtr<UMaterialInterface>>& slot : dirtySlots)
+		preparedSlots.Add(slot.Key, PrepareMaterial(slot.Value.Get()));
+
+	FScopeLock sc(&m_RefreshLock);
+	// Released components keep their events until they are destroyed
+	if (!m_Built || m_Shapes.Num() == 0)
+		return;
+
+	m_PreparedMaterialSlots.Append(MoveTemp(preparedSlots));
+	MarkMaterialsChangesAsDirty();
+}
+
 bool URPRStaticMeshComponent::RPRThread_Update()
 {
 	check(!IsInGameThread());
@@ -418,20 +509,14 @@ bool URPRStaticMeshComponent::RPRThread_Update()
 		return (false);
 	}
 
+	RPR_TRACE_SCOPE_DETAIL("Update mesh", *GetOwner()->GetName());
+
 	bool bNeedRebuild = false;
 	{
 		FScopeLock sc(&m_RefreshLock);
 
 		bNeedRebuild |= UpdateDirtyMaterialsIFN();
-		// TODO : Re-enable to update correctly the material
-		// Disabled for now because it crashes in specific case :
-		// - enable RPR rendering
-		// - change the material of the mesh with another RPR material
-		// - delete the mesh
-		// - undo with Ctrl+Z
-		// - crash during the commit of the material parameters
-		// bNeedRebuild |= UpdateDirtyMaterialsChangesIFN();
-
+		bNeedRebuild |= UpdateDirtyMaterialSlotsIFN();
 	}
 
 	return (bNeedRebuild | Super::RPRThread_Update());
@@ -445,60 +530,34 @@ bool URPRStaticMeshComponent::UpdateDirtyMaterialsIFN()
 	{
 		FRPRXMaterialLibrary& rprMaterialLibrary = IRPRCore::GetResources()->GetRPRMaterialLibrary();
 
-		URPRMaterial* material = nullptr;
+		TWeakObjectPtr<URPRMaterial> material;
 		while (m_dirtyMaterialsQueue.Dequeue(material))
 		{
-			rprMaterialLibrary.RecacheMaterial(material);
+			// The material can be deleted before the RPR thread gets to it
+			if (material.IsValid())
+				rprMaterialLibrary.RecacheMaterial(material.Get());
 		}
 	}
 
 	return (bNeedRebuild);
 }
 
-bool URPRStaticMeshComponent::UpdateDirtyMaterialsChangesIFN()
+bool URPRStaticMeshComponent::UpdateDirtyMaterialSlotsIFN()
 {
 	const bool bNeedRebuild = HasMaterialsChanged();
 
 	if (bNeedRebuild)
 	{
-		UStaticMeshComponent* staticMeshComponent = Cast<UStaticMeshComponent>(SrcComponent);
-		check(staticMeshComponent);
-
-		UStaticMesh* currentStaticMesh = staticMeshComponent->GetStaticMesh();
-		check(currentStaticMesh);
-
-		for (int32 materialIndex = 0; materialIndex < m_lastMaterialsList.Num(); ++materialIndex)
+		// Resolved and parsed by PrepareUpdate, only the shapes bound to that slot are touched
+		for (const TPair<int32, FRPRPreparedMaterial>& slot : m_PreparedMaterialSlots)
 		{
-			UMaterialInterface* material = m_lastMaterialsList[materialIndex];
-			URPRMaterial* rprMaterial = Cast<URPRMaterial>(material);
-
-			if (!m_cachedMaterials.IsValidIndex(materialIndex) || m_cachedMaterials[materialIndex] != material)
+			for (FRPRShape& shape : m_Shapes)
 			{
-				FRPRShape* shape = FindShapeByMaterialIndex(materialIndex);
-				if (shape != nullptr)
-				{
-					if (rprMaterial != nullptr)
-					{
-						if (m_cachedMaterials.IsValidIndex(materialIndex))
-						{
-							URPRMaterial* oldMaterial = Cast<URPRMaterial>(m_cachedMaterials[materialIndex]);
-							if (oldMaterial != nullptr)
-							{
-								m_OnMaterialChangedDelegateHandles.Unsubscribe(oldMaterial);
-							}
-						}
-
-						BuildRPRMaterial(shape->m_RprShape, rprMaterial);
-					}
-					else
-					{
-						AttachDummyMaterial(shape->m_RprShape);
-					}
-				}
+				if (shape.m_UEMaterialIndex == slot.Key)
+					BindMaterialOnShape(shape, slot.Value);
 			}
 		}
-
-		m_cachedMaterials = m_lastMaterialsList;
+		m_PreparedMaterialSlots.Empty();
 	}
 
 	return (bNeedRebuild);
@@ -525,6 +584,11 @@ void URPRStaticMeshComponent::ClearMaterialChangedWatching()
 	m_OnMaterialChangedDelegateHandles.UnsubscribeAll();
 }
 
+bool	URPRStaticMeshComponent::NeedsTick() const
+{
+	return CVarRPRPollMaterials.GetValueOnGameThread() != 0 || Super::NeedsTick();
+}
+
 void	URPRStaticMeshComponent::TickComponent(float deltaTime, ELevelTick tickType, FActorComponentTickFunction *tickFunction)
 {
 	SCOPE_CYCLE_COUNTER(STAT_ProRender_UpdateMeshes);
@@ -538,11 +602,9 @@ void	URPRStaticMeshComponent::TickComponent(float deltaTime, ELevelTick tickType
 		}
 	}
 
-	if (m_RefreshLock.TryLock())
-	{
-		WatchMaterialsChanges();
-		m_RefreshLock.Unlock();
-	}
+	// Slot changes are caught by WatchMaterials
+	if (CVarRPRPollMaterials.GetValueOnGameThread() != 0)
+		DetectMaterialSlotChanges();
 
 	Super::TickComponent(deltaTime, tickType, tickFunction);
 }
@@ -567,91 +629,263 @@ int URPRStaticMeshComponent::SetInstanceTransforms(UInstancedStaticMeshComponent
 	return status;
 }
 
-void	URPRStaticMeshComponent::WatchMaterialsChanges()
+void	URPRStaticMeshComponent::DetectMaterialSlotChanges()
 {
-	if (SrcComponent == nullptr) return;
-
 	UStaticMeshComponent* staticMeshComponent = Cast<UStaticMeshComponent>(SrcComponent);
+	if (staticMeshComponent == nullptr)
+		return;
+
+	FScopeLock sc(&m_RefreshLock);
+	// Released components keep their events until they are destroyed
+	if (!m_Built || m_Shapes.Num() == 0)
+		return;
 
 	const int32 numMaterials = staticMeshComponent->GetNumMaterials();
-	if (m_cachedMaterials.Num() != numMaterials)
+	const int32 numSlots = FMath::Max(numMaterials, m_cachedMaterials.Num());
+
+	TArray<UMaterialInterface*> materials;
+	materials.SetNumUninitialized(numMaterials);
+
+	bool bChanged = false;
+	for (int32 materialIndex = 0; materialIndex < numSlots; ++materialIndex)
 	{
-		UpdateLastMaterialList();
-		MarkMaterialsChangesAsDirty();
-		return;
+		UMaterialInterface* material = materialIndex < numMaterials ? staticMeshComponent->GetMaterial(materialIndex) : nullptr;
+		UMaterialInterface* oldMaterial = m_cachedMaterials.IsValidIndex(materialIndex) ? m_cachedMaterials[materialIndex] : nullptr;
+		if (materialIndex < numMaterials)
+			materials[materialIndex] = material;
+
+		if (material == oldMaterial && m_cachedMaterials.IsValidIndex(materialIndex))
+			continue;
+
+		bChanged = true;
+		m_DirtyMaterialSlots.Add(materialIndex, material);
+
+		// Subscriptions are counted per shape, as done in BuildMaterials
+		// Delegates are only touched from the game thread, the shapes are rebound on the RPR thread
+		URPRMaterial* oldRPRMaterial = Cast<URPRMaterial>(oldMaterial);
+		URPRMaterial* rprMaterial = Cast<URPRMaterial>(material);
+		for (const FRPRShape& shape : m_Shapes)
+		{
+			if (shape.m_UEMaterialIndex != materialIndex)
+				continue;
+			if (oldRPRMaterial != nullptr)
+				m_OnMaterialChangedDelegateHandles.Unsubscribe(oldRPRMaterial);
+			if (rprMaterial != nullptr)
+				m_OnMaterialChangedDelegateHandles.Subscribe(rprMaterial);
+		}
 	}
 
-	m_cachedMaterials.Empty(numMaterials);
-	m_cachedMaterials.AddUninitialized(numMaterials);
-	for (int32 materialIndex = 0; materialIndex < numMaterials; ++materialIndex)
+	if (!bChanged)
+		return;
+
+	UpdateMaterialUsers(m_cachedMaterials, materials);
+	m_cachedMaterials = MoveTemp(materials);
+	RequestPrepareUpdate();
+}
+
+void	URPRStaticMeshComponent::OnUsedMaterialEdited(UMaterialInterface* Material)
+{
+	FScopeLock sc(&m_RefreshLock);
+	// Released components keep their events until they are destroyed
+	if (!m_Built || m_Shapes.Num() == 0)
+		return;
+
+	bool bUsed = false;
+	for (int32 materialIndex = 0; materialIndex < m_cachedMaterials.Num(); ++materialIndex)
 	{
-		if (m_cachedMaterials[materialIndex] != staticMeshComponent->GetMaterial(materialIndex))
+		if (m_cachedMaterials[materialIndex] == Material)
 		{
-			UpdateLastMaterialList();
-			MarkMaterialsChangesAsDirty();
-			return;
+			m_DirtyMaterialSlots.Add(materialIndex, Material);
+			bUsed = true;
 		}
 	}
+
+	if (bUsed)
+		RequestPrepareUpdate();
 }
 
-void	URPRStaticMeshComponent::UpdateLastMaterialList()
+void	URPRStaticMeshComponent::WatchMaterials()
 {
-	UStaticMeshComponent* staticMeshComponent = Cast<UStaticMeshComponent>(SrcComponent);
+	check(IsInGameThread());
+
+	// One handler for all the components, edits are dispatched through MaterialUsers
+	if (!RenderStateDirtyHandle.IsValid())
+		RenderStateDirtyHandle = UActorComponent::MarkRenderStateDirtyEvent.AddStatic(&URPRStaticMeshComponent::OnSrcRenderStateDirty);
+#if WITH_EDITOR
+	if (!ObjectPropertyChangedHandle.IsValid())
+		ObjectPropertyChangedHandle = FCoreUObjectDelegates::OnObjectPropertyChanged.AddStatic(&URPRStaticMeshComponent::OnObjectPropertyChanged);
+#endif
 
-	const int32 numMaterials = staticMeshComponent->GetNumMaterials();
-	m_lastMaterialsList.Empty(numMaterials);
-	m_lastMaterialsList.AddUninitialized(numMaterials);
-	for (int32 materialIdx = 0; materialIdx < numMaterials; ++materialIdx)
 	{
-		m_lastMaterialsList[materialIdx] = staticMeshComponent->GetMaterial(materialIdx);
+		FScopeLock lock(&MaterialUsersLock);
+		WatchedSrcComponents.Add(SrcComponent, this);
 	}
+	UpdateMaterialUsers(TArray<UMaterialInterface*>(), m_cachedMaterials);
 }
 
-RPR::FResult URPRStaticMeshComponent::DetachCurrentMaterial(RPR::FShape Shape)
+void	URPRStaticMeshComponent::UnwatchMaterials()
 {
-	auto resources = IRPRCore::GetResources();
-	RPR::FResult status;
+	UpdateMaterialUsers(m_cachedMaterials, TArray<UMaterialInterface*>());
 
-	status = rprShapeSetMaterial(Shape, nullptr);
-	return status;
+	FScopeLock lock(&MaterialUsersLock);
+	if (SrcComponent != nullptr)
+	{
+		URPRStaticMeshComponent** watcher = WatchedSrcComponents.Find(SrcComponent);
+		if (watcher != nullptr && *watcher == this)
+			WatchedSrcComponents.Remove(SrcComponent);
+	}
+	else
+	{
+		for (auto it = WatchedSrcComponents.CreateIterator(); it; ++it)
+		{
+			if (it->Value == this)
+				it.RemoveCurrent();
+		}
+	}
 }
 
-FRPRShape* URPRStaticMeshComponent::FindShapeByMaterialIndex(int32 MaterialIndex)
+void	URPRStaticMeshComponent::UpdateMaterialUsers(const TArray<UMaterialInterface*>& OldMaterials, const TArray<UMaterialInterface*>& NewMaterials)
 {
-	for (int32 i = 0; i < m_Shapes.Num(); ++i)
+	FScopeLock lock(&MaterialUsersLock);
+
+	for (UMaterialInterface* material : OldMaterials)
 	{
-		if (m_Shapes[i].m_UEMaterialIndex == MaterialIndex)
+		if (material != nullptr)
+			MaterialUsers.Remove(material, this);
+	}
+	for (UMaterialInterface* material : NewMaterials)
+	{
+		if (material != nullptr)
+			MaterialUsers.AddUnique(material, this);
+	}
+}
+
+void	URPRStaticMeshComponent::OnSrcRenderStateDirty(UActorComponent& Component)
+{
+	// SetMaterial on the source component goes through here
+	URPRStaticMeshComponent* watcher = nullptr;
+	{
+		FScopeLock lock(&MaterialUsersLock);
+		URPRStaticMeshComponent** found = WatchedSrcComponents.Find(&Component);
+		if (found == nullptr)
+			return;
+		watcher = *found;
+	}
+	watcher->DetectMaterialSlotChanges();
+}
+
+#if WITH_EDITOR
+void	URPRStaticMeshComponent::OnObjectPropertyChanged(UObject* Object, FPropertyChangedEvent& PropertyChangedEvent)
+{
+	// Slot overrides edited from the details panel
+	UActorComponent* component = Cast<UActorComponent>(Object);
+	if (component != nullptr)
+	{
+		OnSrcRenderStateDirty(*component);
+		return;
+	}
+
+	// RPR materials notify their users through OnRPRMaterialChanged
+	UMaterialInterface* editedMaterial = Cast<UMaterialInterface>(Object);
+	if (editedMaterial == nullptr || editedMaterial->IsA<URPRMaterial>())
+		return;
+
+	TArray<TPair<URPRStaticMeshComponent*, UMaterialInterface*>> affectedUsers;
+	{
+		FScopeLock lock(&MaterialUsersLock);
+
+		TArray<const UMaterialInterface*> usedMaterials;
+		MaterialUsers.GetKeys(usedMaterials);
+		for (const UMaterialInterface* usedMaterial : usedMaterials)
 		{
-			return &m_Shapes[i];
+			// Editing a parent material reaches every instance deriving from it
+			const UMaterialInterface* material = usedMaterial;
+			while (material != nullptr && material != editedMaterial)
+			{
+				const UMaterialInstance* materialInstance = Cast<UMaterialInstance>(material);
+				material = materialInstance != nullptr ? materialInstance->Parent : nullptr;
+			}
+			if (material == nullptr)
+				continue;
+
+			TArray<URPRStaticMeshComponent*> users;
+			MaterialUsers.MultiFind(usedMaterial, users);
+			for (URPRStaticMeshComponent* user : users)
+				affectedUsers.Emplace(user, const_cast<UMaterialInterface*>(usedMaterial));
 		}
 	}
-	return (nullptr);
+
+	// Outside of MaterialUsersLock: OnUsedMaterialEdited takes the component refresh lock
+	for (const TPair<URPRStaticMeshComponent*, UMaterialInterface*>& user : affectedUsers)
+		user.Key->OnUsedMaterialEdited(user.Value);
 }
+#endif
 
 bool	URPRStaticMeshComponent::RebuildTransforms()
 {
 	check(!IsInGameThread());
 	int status;
 
-	UInstancedStaticMeshComponent	*instancedMeshComponent = Cast<UInstancedStaticMeshComponent>(SrcComponent); // Foliage, instanced meshes, ..
-	RadeonProRender::matrix			componentMatrix = BuildMatrixWithScale(SrcComponent->GetComponentToWorld(), RPR::Constants::SceneTranslationScaleFromUE4ToRPR);
+	FMemMark	mark(FMemStack::Get());
+	RPR::ScratchMemory::TScratchArray<RPR::FShape>	shapes;
+	RPR::ScratchMemory::TScratchArray<FTransform>	transforms;
+	GatherShapeTransforms(shapes, transforms);
 
-	const uint32	shapeCount = m_Shapes.Num();
-	for (uint32 iShape = 0; iShape < shapeCount; ++iShape)
+	RPR::ScratchMemory::TScratchArray<RadeonProRender::matrix>	matrices;
+	matrices.SetNumUninitialized(shapes.Num());
+	BuildMatricesWithScale(transforms, matrices, RPR::Constants::SceneTranslationScaleFromUE4ToRPR);
+
+	for (int32 iShape = 0; iShape < shapes.Num(); ++iShape)
 	{
-		status = SetInstanceTransforms(instancedMeshComponent, &componentMatrix, m_Shapes[iShape].m_RprShape, m_Shapes[iShape].m_InstanceIndex);
+		status = rprShapeSetTransform(shapes[iShape], RPR_TRUE, &matrices[iShape].m00);
 		CHECK_ERROR(status, TEXT("Couldn't refresh RPR mesh transforms"));
 	}
 	return true;
 }
 
+void	URPRStaticMeshComponent::RPRThread_GatherShapeTransforms(RPR::ScratchMemory::TScratchArray<RPR::FShape>& OutShapes, RPR::ScratchMemory::TScratchArray<FTransform>& OutTransforms)
+{
+	check(!IsInGameThread());
+
+	FScopeLock sc(&m_RefreshLock);
+	if ((m_RebuildFlags & PROPERTY_REBUILD_TRANSFORMS) == 0)
+		return;
+
+	m_RebuildFlags &= ~PROPERTY_REBUILD_TRANSFORMS;
+	GatherShapeTransforms(OutShapes, OutTransforms);
+}
+
+void	URPRStaticMeshComponent::GatherShapeTransforms(RPR::ScratchMemory::TScratchArray<RPR::FShape>& OutShapes, RPR::ScratchMemory::TScratchArray<FTransform>& OutTransforms) const
+{
+	UInstancedStaticMeshComponent	*instancedMeshComponent = Cast<UInstancedStaticMeshComponent>(SrcComponent); // Foliage, instanced meshes, ..
+	const FTransform&				componentTransform = SrcComponent->GetComponentToWorld();
+
+	OutShapes.Reserve(OutShapes.Num() + m_Shapes.Num());
+	OutTransforms.Reserve(OutTransforms.Num() + m_Shapes.Num());
+	for (const FRPRShape& shape : m_Shapes)
+	{
+		FTransform	transform = componentTransform;
+		if (instancedMeshComponent != nullptr && instancedMeshComponent->GetInstanceCount() > 0)
+		{
+			FTransform	instanceTransform;
+			if (instancedMeshComponent->GetInstanceTransform(shape.m_InstanceIndex, instanceTransform, true))
+				transform = instanceTransform;
+		}
+
+		OutShapes.Add(shape.m_RprShape);
+		OutTransforms.Add(transform);
+	}
+}
+
 void	URPRStaticMeshComponent::MarkMaterialsAsDirty()
 {
 	m_RebuildFlags |= PROPERTY_REBUILD_MATERIALS;
+	WakeRenderer();
 }
 void URPRStaticMeshComponent::MarkMaterialsChangesAsDirty()
 {
 	m_RebuildFlags |= PROPERTY_MATERIALS_CHANGES;
+	WakeRenderer();
 }
 
 bool URPRStaticMeshComponent::HasMaterialsChanged() const
@@ -666,24 +900,34 @@ bool URPRStaticMeshComponent::AreMaterialsDirty() const
 
 void	URPRStaticMeshComponent::ReleaseResources()
 {
-	if (m_Shapes.Num() > 0)
 	{
-		check(Scene != nullptr);
-		uint32	shapeCount = m_Shapes.Num();
-		for (uint32 iShape = 0; iShape < shapeCount; ++iShape)
-		{
-			if (!m_Shapes[iShape].m_RprShape)
-				continue;
+		// Material events can still be in flight on the game thread
+		FScopeLock sc(&m_RefreshLock);
+
+		UnwatchMaterials();
+		m_cachedMaterials.Empty();
+		m_DirtyMaterialSlots.Empty();
+		m_PreparedMaterialSlots.Empty();
 
-			if (m_Shapes[iShape].m_RprxMaterial.IsValid())
+		if (m_Shapes.Num() > 0)
+		{
+			check(Scene != nullptr);
+			uint32	shapeCount = m_Shapes.Num();
+			for (uint32 iShape = 0; iShape < shapeCount; ++iShape)
 			{
-				(void)rprShapeSetMaterial(m_Shapes[iShape].m_RprShape, nullptr);
-			}
+				if (!m_Shapes[iShape].m_RprShape)
+					continue;
 
-			RPR::Scene::DetachShape(Scene->m_RprScene, m_Shapes[iShape].m_RprShape);
-			RPR::DeleteObject(m_Shapes[iShape].m_RprShape);
+				if (m_Shapes[iShape].m_RprxMaterial.IsValid())
+				{
+					(void)rprShapeSetMaterial(m_Shapes[iShape].m_RprShape, nullptr);
+				}
+
+				RPR::Scene::DetachShape(Scene->m_RprScene, m_Shapes[iShape].m_RprShape);
+				RPR::DeleteObject(m_Shapes[iShape].m_RprShape);
+			}
+			m_Shapes.Empty();
 		}
-		m_Shapes.Empty();
 	}
 
 	ClearMaterialChangedWatching();
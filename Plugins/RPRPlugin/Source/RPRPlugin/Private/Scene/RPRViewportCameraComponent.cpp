@@ -57,6 +57,7 @@ URPRViewportCameraComponent::URPRViewportCameraComponent()
 :	m_RprCamera(NULL)
 ,	m_CachedCameraPos(FVector::ZeroVector)
 ,	m_CachedCameraLookAt(FVector::ZeroVector)
+,	m_LastMoveTime(0.0)
 ,	m_CachedIsLocked(false)
 ,	m_CachedProjectionMode(ECameraProjectionMode::Perspective)
 ,	m_CachedFocalLength(0.0f)
@@ -80,6 +81,7 @@ void	URPRViewportCameraComponent::SetAsActiveCamera()
 {
 	check(Scene != NULL);
 	Scene->m_ActiveCamera = this;
+	SetComponentTickEnabled(true);
 
 	if (m_RprCamera == NULL)
 		return;
@@ -87,6 +89,7 @@ void	URPRViewportCameraComponent::SetAsActiveCamera()
 	m_RefreshLock.Lock();
 	m_RebuildFlags |= PROPERTY_REBUILD_ACTIVE_CAMERA;
 	m_RefreshLock.Unlock();
+	WakeRenderer();
 
 	if (!m_Orbit)
 		RebuildCameraProperties(false);
@@ -466,6 +469,9 @@ void	URPRViewportCameraComponent::RebuildCameraProperties(bool force)
 			m_RebuildFlags |= PROPERTY_REBUILD_TRANSFORMS;
 			m_CachedCameraPos = camPos;
 			m_CachedCameraLookAt = camLookAt;
+			if (!force)
+				m_LastMoveTime = FPlatformTime::Seconds();
+			WakeRenderer();
 		}
 		if (cineCam != NULL)
 		{
@@ -509,6 +515,9 @@ void	URPRViewportCameraComponent::RebuildCameraProperties(bool force)
 			m_RebuildFlags |= PROPERTY_REBUILD_TRANSFORMS;
 			m_CachedCameraPos = camPos;
 			m_CachedCameraLookAt = camLookAt;
+			if (!force)
+				m_LastMoveTime = FPlatformTime::Seconds();
+			WakeRenderer();
 		}
 	}
 
@@ -571,6 +580,12 @@ void	URPRViewportCameraComponent::UpdateOrbitCamera()
 	}
 }
 
+bool	URPRViewportCameraComponent::NeedsTick() const
+{
+	// Only the active camera follows its source, the others stop ticking until they're activated
+	return (Scene != NULL && Scene->m_ActiveCamera == this) || Super::NeedsTick();
+}
+
 void	URPRViewportCameraComponent::TickComponent(float deltaTime, ELevelTick tickType, FActorComponentTickFunction *tickFunction)
 {
 	SCOPE_CYCLE_COUNTER(STAT_ProRender_UpdateViewportCamera);
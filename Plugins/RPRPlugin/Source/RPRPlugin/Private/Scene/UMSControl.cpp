@@ -19,6 +19,7 @@
 #include <fstream>
 #include <CoreMinimal.h>
 #include <Engine/Texture.h>
+#include <HAL/FileManager.h>
 namespace fs = std;
 
 namespace rpr
@@ -38,10 +39,24 @@ namespace rpr
 	void UMSControl::Clear()
 	{
 		materialEnables.clear();
+		loadedFilename.clear();
+		loadedTimeStamp = 0;
+		loadedFileSize = -1;
 	}
 
 	void UMSControl::LoadControlData(const std::string & filename)
 	{
+		const FString	path = UTF8_TO_TCHAR(filename.c_str());
+		const int64		timeStamp = IFileManager::Get().GetTimeStamp(*path).GetTicks();
+		const int64		fileSize = IFileManager::Get().FileSize(*path);
+
+		// Same file, unchanged: keep the parsed data
+		if (filename == loadedFilename && timeStamp == loadedTimeStamp && fileSize == loadedFileSize)
+			return;
+		loadedFilename = filename;
+		loadedTimeStamp = timeStamp;
+		loadedFileSize = fileSize;
+
 		// Allow for reload
 		materialEnables.clear();
 
@@ -17,11 +17,11 @@
 #include "Scene/URadeonMaterialParser.h"
 
 #include "RPRXVirtualNode.h"
-#include "Scene/StaticMeshComponent/RPRShape.h"
 
 #include "Material/RPRXMaterialLibrary.h"
 #include "RPRCoreModule.h"
 #include "RPRSettings.h"
+#include "Helpers/RPRTrace.h"
 #include "RPRPlugin.h"
 #include "Scene/RPRScene.h"
 #include "Scene/RPRCameraComponent.h"
@@ -154,15 +154,17 @@ FString URadeonMaterialParser::GetId(UMaterialExpression* expression)
 }
 
 
-void URadeonMaterialParser::Process(FRPRShape& shape, UMaterialInterface* materialInterface)
+RPR::FRPRXMaterialNodePtr URadeonMaterialParser::Parse(UMaterialInterface* materialInterface)
 {
 #if WITH_EDITORONLY_DATA
+	RPR_TRACE_SCOPE_DETAIL("Parse material", *materialInterface->GetName());
+
 	UMaterial* material = materialInterface->GetMaterial();
 	if (!material)
-		return;
+		return nullptr;
 
 	if (!material->BaseColor.IsConnected() && !material->EmissiveColor.IsConnected())
-		return;
+		return nullptr;
 
 	CurrentMaterialInstance = Cast<UMaterialInstance>(materialInterface);
 
@@ -175,7 +177,7 @@ void URadeonMaterialParser::Process(FRPRShape& shape, UMaterialInterface* materi
 		: material->GetName();
 
 	if (materialName.IsEmpty())
-		return;
+		return nullptr;
 
 	idPrefix = materialName + TEXT("_");
 	idPrefixHandler = idPrefix;
@@ -186,9 +188,8 @@ void URadeonMaterialParser::Process(FRPRShape& shape, UMaterialInterface* materi
 
 	RPR::FRPRXMaterialNodePtr uberMaterialPtr = materialLibrary.createMaterial(materialName, RPR_MATERIAL_NODE_UBERV2);
 	if (!uberMaterialPtr)
-		return;
+		return nullptr;
 
-	shape.m_RprxNodeMaterial = uberMaterialPtr;
 	CurrentMaterial = uberMaterialPtr;
 
 	materialLibrary.ReleaseCache();
@@ -423,8 +424,9 @@ void URadeonMaterialParser::Process(FRPRShape& shape, UMaterialInterface* materi
 		LOG_ERROR(status, TEXT("Can't set Coating Transmission Color"));
 	}
 
-	status = rprShapeSetMaterial(shape.m_RprShape, uberMaterialPtr->GetRawMaterial());
-	LOG_ERROR(status, TEXT("Can't set shape material"));
+	return uberMaterialPtr;
+#else
+	return nullptr;
 #endif
 }
 
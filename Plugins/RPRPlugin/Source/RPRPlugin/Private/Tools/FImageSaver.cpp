@@ -16,6 +16,8 @@
 
 #include "FImageSaver.h"
 
+#if WITH_RPR_LINKED_IMAGE_LIBRARIES
+
 #ifdef TEXT
 #undef TEXT
 #endif
@@ -57,3 +59,90 @@ bool FImageSaver::WriteFloatImageToFile(const FString& filename, const void* imd
 {
 	return WriteImageToFile(filename, OIIO::TypeDesc::FLOAT, imdata, width, height);
 }
+
+#else
+
+#include "IImageWrapper.h"
+#include "IImageWrapperModule.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Modules/ModuleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogImageSaver, Log, All);
+
+/*
+* OpenImageIO only has a C++ API, its exported names depend on how the library was built so it can't be resolved at runtime.
+* Without it, the formats offered by the save dialog (png, bmp, tga) are written with the engine writers.
+*/
+namespace
+{
+	bool WritePNG(const FString& filename, const uint8* rgba, const int width, const int height)
+	{
+		IImageWrapperModule& imageWrapperModule = FModuleManager::LoadModuleChecked<IImageWrapperModule>(FName("ImageWrapper"));
+		TSharedPtr<IImageWrapper> imageWrapper = imageWrapperModule.CreateImageWrapper(EImageFormat::PNG);
+		if (!imageWrapper.IsValid() || !imageWrapper->SetRaw(rgba, width * height * 4, width, height, ERGBFormat::RGBA, 8))
+			return false;
+
+		const auto& compressed = imageWrapper->GetCompressed();
+		return FFileHelper::SaveArrayToFile(compressed, *filename);
+	}
+
+	bool WriteBMP(const FString& filename, const uint8* rgba, const int width, const int height)
+	{
+		TArray<FColor> colors;
+		colors.SetNumUninitialized(width * height);
+		for (int32 i = 0; i < colors.Num(); ++i)
+			colors[i] = FColor(rgba[i * 4], rgba[i * 4 + 1], rgba[i * 4 + 2], rgba[i * 4 + 3]);
+
+		return FFileHelper::CreateBitmap(*filename, width, height, colors.GetData(), nullptr, &IFileManager::Get(), nullptr, true);
+	}
+
+	bool WriteTGA(const FString& filename, const uint8* rgba, const int width, const int height)
+	{
+		// Uncompressed 32 bits true color, top-left origin
+		const int32 headerSize = 18;
+		TArray<uint8> data;
+		data.SetNumZeroed(headerSize + width * height * 4);
+		data[2] = 2;
+		data[12] = width & 0xFF;
+		data[13] = (width >> 8) & 0xFF;
+		data[14] = height & 0xFF;
+		data[15] = (height >> 8) & 0xFF;
+		data[16] = 32;
+		data[17] = 0x28;
+
+		uint8* bgra = data.GetData() + headerSize;
+		for (int32 i = 0; i < width * height; ++i)
+		{
+			bgra[i * 4] = rgba[i * 4 + 2];
+			bgra[i * 4 + 1] = rgba[i * 4 + 1];
+			bgra[i * 4 + 2] = rgba[i * 4];
+			bgra[i * 4 + 3] = rgba[i * 4 + 3];
+		}
+		return FFileHelper::SaveArrayToFile(data, *filename);
+	}
+}
+
+bool FImageSaver::WriteUint8ImageToFile(const FString& filename, const void* imdata, const int width, const int height)
+{
+	const FString	extension = FPaths::GetExtension(filename);
+	const uint8*	rgba = static_cast<const uint8*>(imdata);
+
+	if (extension == TEXT("png"))
+		return WritePNG(filename, rgba, width, height);
+	if (extension == TEXT("bmp"))
+		return WriteBMP(filename, rgba, width, height);
+	if (extension == TEXT("tga"))
+		return WriteTGA(filename, rgba, width, height);
+
+	UE_LOG(LogImageSaver, Error, TEXT("Can't write '%s': only png, bmp and tga images can be saved without OpenImageIO"), *filename);
+	return false;
+}
+
+bool FImageSaver::WriteFloatImageToFile(const FString& filename, const void* imdata, const int width, const int height)
+{
+	UE_LOG(LogImageSaver, Error, TEXT("Can't write '%s': float images need OpenImageIO"), *filename);
+	return false;
+}
+
+#endif // WITH_RPR_LINKED_IMAGE_LIBRARIES
@@ -35,6 +35,11 @@ FRPRViewportClient::FRPRViewportClient(FRPRPluginModule *plugin)
 ,	m_PrevMousePos(FIntPoint::ZeroValue)
 ,	m_StartOrbit(false)
 ,	m_StartPanning(false)
+,	m_RenderOffset(FVector2D::ZeroVector)
+,	m_RenderDimensions(FVector2D::ZeroVector)
+,	m_DrawingRegion(false)
+,	m_RegionStartUV(FVector2D::ZeroVector)
+,	m_RegionEndUV(FVector2D::ZeroVector)
 {
 }
 
@@ -70,6 +75,9 @@ void	FRPRViewportClient::Draw(FViewport *viewport, FCanvas *canvas)
 		(ratio.X > 1.0f) ? ((viewportDimensions.X - (viewportDimensions.X / ratio.X)) * 0.5f) : 0,
 		(ratio.Y > 1.0f) ? ((viewportDimensions.Y - (viewportDimensions.Y / ratio.Y)) * 0.5f) : 0);
 
+	m_RenderOffset = renderOffset;
+	m_RenderDimensions = textureDimensions;
+
 #if WITH_EDITOR
 #if  ENGINE_MINOR_VERSION >= 24
 	TRefCountPtr<FBatchedElementParameters>	batchedElementParameters = new FBatchedElementTexture2DPreviewParameters(0, false, false, false, false, false, false);
@@ -84,10 +92,74 @@ void	FRPRViewportClient::Draw(FViewport *viewport, FCanvas *canvas)
 	tileItem.BatchedElementParameters = batchedElementParameters;
 	canvas->DrawItem(tileItem);
 #endif
+
+	DrawRegionOfInterest(canvas);
+}
+
+void	FRPRViewportClient::DrawRegionOfInterest(FCanvas *canvas)
+{
+	FBox2D	region = m_Plugin->GetRegionOfInterest();
+	if (m_DrawingRegion)
+	{
+		region = FBox2D(ForceInit);
+		region += m_RegionStartUV;
+		region += m_RegionEndUV;
+	}
+	if (!region.bIsValid)
+		return;
+
+	static const FLinearColor	kRegionColor(1.0f, 0.6f, 0.0f);
+	FCanvasBoxItem	boxItem(m_RenderOffset + region.Min * m_RenderDimensions, region.GetSize() * m_RenderDimensions);
+	boxItem.SetColor(kRegionColor);
+	canvas->DrawItem(boxItem);
+}
+
+FVector2D	FRPRViewportClient::ViewportToTextureUV(const FIntPoint &viewportPos) const
+{
+	if (m_RenderDimensions.X <= 0.0f || m_RenderDimensions.Y <= 0.0f)
+		return FVector2D::ZeroVector;
+	const FVector2D	uv = (FVector2D(viewportPos) - m_RenderOffset) / m_RenderDimensions;
+	return FVector2D(FMath::Clamp(uv.X, 0.0f, 1.0f), FMath::Clamp(uv.Y, 0.0f, 1.0f));
+}
+
+bool	FRPRViewportClient::HandleRegionOfInterestInput(FViewport *viewport, FKey key, EInputEvent e)
+{
+	if (key == EKeys::LeftMouseButton)
+	{
+		if (e == IE_Pressed && IsCtrlDown(viewport))
+		{
+			m_RegionStartUV = m_RegionEndUV = ViewportToTextureUV(FIntPoint(viewport->GetMouseX(), viewport->GetMouseY()));
+			m_DrawingRegion = true;
+			return true;
+		}
+		if (e == IE_Released && m_DrawingRegion)
+		{
+			m_DrawingRegion = false;
+
+			FBox2D	region(ForceInit);
+			region += m_RegionStartUV;
+			region += m_RegionEndUV;
+
+			// A click without drag clears it, like Ctrl + right click
+			if (region.GetArea() <= KINDA_SMALL_NUMBER)
+				region = FBox2D(ForceInit);
+			m_Plugin->SetRegionOfInterest(region);
+			return true;
+		}
+	}
+	else if (key == EKeys::RightMouseButton && e == IE_Pressed && IsCtrlDown(viewport))
+	{
+		m_DrawingRegion = false;
+		m_Plugin->SetRegionOfInterest(FBox2D(ForceInit));
+		return true;
+	}
+	return false;
 }
 
 bool	FRPRViewportClient::InputKey(FViewport *viewport, int32 controllerId, FKey key, EInputEvent e, float amountDepressed, bool gamepad)
 {
+	if (HandleRegionOfInterestInput(viewport, key, e))
+		return true;
 	if (!m_Plugin->IsOrbitting())
 		return false;
 	if (key == EKeys::LeftMouseButton)
@@ -120,6 +192,11 @@ bool	FRPRViewportClient::InputKey(FViewport *viewport, int32 controllerId, FKey
 
 void	FRPRViewportClient::CapturedMouseMove(FViewport *inViewport, int32 inMouseX, int32 inMouseY)
 {
+	if (m_DrawingRegion)
+	{
+		m_RegionEndUV = ViewportToTextureUV(FIntPoint(inMouseX, inMouseY));
+		return;
+	}
 	if (!m_Plugin->IsOrbitting())
 		return;
 	if (m_StartOrbit)
@@ -34,10 +34,24 @@ public:
 	virtual void		CapturedMouseMove(FViewport *inViewport, int32 inMouseX, int32 inMouseY) override;
 
 	FVector2D			CalculateTextureDimensions(const class UTexture2DDynamic *renderTexture, const FVector2D &viewportDimensions) const;
+private:
+	/* Ctrl + left drag draws the region of interest, Ctrl + right click clears it */
+	bool				HandleRegionOfInterestInput(FViewport *viewport, FKey key, EInputEvent e);
+	FVector2D			ViewportToTextureUV(const FIntPoint &viewportPos) const;
+	void				DrawRegionOfInterest(class FCanvas *canvas);
+
 private:
 	class FRPRPluginModule	*m_Plugin;
 
 	FIntPoint				m_PrevMousePos;
 	bool					m_StartOrbit;
 	bool					m_StartPanning;
+
+	// Where the render texture was drawn last frame, in viewport pixels
+	FVector2D				m_RenderOffset;
+	FVector2D				m_RenderDimensions;
+
+	bool					m_DrawingRegion;
+	FVector2D				m_RegionStartUV;
+	FVector2D				m_RegionEndUV;
 };
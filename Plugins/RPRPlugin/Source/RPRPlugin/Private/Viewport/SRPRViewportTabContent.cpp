@@ -45,7 +45,6 @@
 #include "Widgets/Notifications/SNotificationList.h"
 #include "Helpers/RPRSceneStandardizer.h"
 #include "Helpers/RPRSceneHelpers.h"
-#include "ProRenderGLTF.h"
 
 #define LOCTEXT_NAMESPACE "SRPRViewportTabContent"
 
@@ -201,49 +200,41 @@ FReply SRPRViewportTabContent::OnSceneExport()
 
 	if (bHasSaved && filenames.Num() > 0)
 	{
-		RPR::FResult status;
-
 		const FString& filename = filenames[0];
 		m_LastExportDirectory = FPaths::GetPath(filename);
 
-		auto resources = IRPRCore::GetResources();
-		RPR::FContext rprContext = resources->GetRPRContext();
-
-		rpr_scene rprScenes = m_Plugin->GetCurrentScene()->m_RprScene;
-		size_t rprScenesCount = 1;
-
-		status = rprExportToGLTF(
-			TCHAR_TO_ANSI(*filename),
-			resources->GetRPRContext(),
-			resources->GetMaterialSystem(),
-			&rprScenes,
-			rprScenesCount,
-			0);
-
-		FText infoText;
-		const FSlateBrush* infoIcon;
+		// Large scenes take minutes to export, keep the editor responsive meanwhile
+		FNotificationInfo Info(LOCTEXT("ExportPending", "Exporting scene..."));
+		Info.bFireAndForget = false;
+		Info.bUseThrobber = true;
+		TSharedPtr<SNotificationItem> notification = FSlateNotificationManager::Get().AddNotification(Info);
+		if (notification.IsValid())
+			notification->SetCompletionState(SNotificationItem::CS_Pending);
 
-		if (RPR::IsResultSuccess(status))
-		{
-			infoText = LOCTEXT("ExportSuccess", "Scene exported!");
-			infoIcon = FEditorStyle::GetBrush(TEXT("NotificationList.SuccessImage"));
-		}
-		else
+		TWeakPtr<SNotificationItem> weakNotification = notification;
+		m_Plugin->GetCurrentScene()->ExportToGLTF(filename, [weakNotification, filename] (bool bSuccess)
 		{
-			infoText = LOCTEXT("ExportFail", "Scene couldn't be exported.");
-			infoIcon = FCoreStyle::Get().GetBrush(TEXT("MessageLog.Error"));
-		}
-
-		FNotificationInfo Info(infoText);
-		Info.bFireAndForget = true;
-		Info.ExpireDuration = 5.0f;
-		Info.Image = infoIcon;
-
-		Info.Hyperlink = FSimpleDelegate::CreateLambda([filename] ()
-		{
-			FPlatformProcess::ExploreFolder(*filename);
+			TSharedPtr<SNotificationItem> notificationItem = weakNotification.Pin();
+			if (!notificationItem.IsValid())
+				return;
+
+			if (bSuccess)
+			{
+				notificationItem->SetText(LOCTEXT("ExportSuccess", "Scene exported!"));
+				notificationItem->SetCompletionState(SNotificationItem::CS_Success);
+				notificationItem->SetHyperlink(FSimpleDelegate::CreateLambda([filename] ()
+				{
+					FPlatformProcess::ExploreFolder(*filename);
+				}));
+			}
+			else
+			{
+				notificationItem->SetText(LOCTEXT("ExportFail", "Scene couldn't be exported."));
+				notificationItem->SetCompletionState(SNotificationItem::CS_Fail);
+			}
+			notificationItem->SetExpireDuration(5.0f);
+			notificationItem->ExpireAndFadeout();
 		});
-		FSlateNotificationManager::Get().AddNotification(Info);
 	}
 
 	return FReply::Handled();
@@ -423,6 +414,12 @@ FText	SRPRViewportTabContent::GetCurrentRenderIteration() const
 		// We could display other infos like "Rendering paused"
 		const uint32	renderIteration = scene->GetRenderIteration();
 
+		float	convergedRatio, secondsLeft;
+		if (scene->GetConvergence(convergedRatio, secondsLeft))
+		{
+			const FString	timeLeft = secondsLeft > 0.0f ? FString::Printf(TEXT(", ~%ds left"), FMath::CeilToInt(secondsLeft)) : FString();
+			return FText::FromString(FString::Printf(TEXT("Render iteration : %d (%d%% converged%s)"), renderIteration, FMath::FloorToInt(convergedRatio * 100.0f), *timeLeft));
+		}
 		return FText::FromString(FString::Printf(TEXT("Render iteration : %d"), renderIteration));
 	}
 	return FText();
@@ -0,0 +1,43 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RPRBenchmarkCommandlet.generated.h"
+
+/**
+* Times the CPU side of scene translation through the plugin code paths: texture loads in the image manager,
+* mesh extraction by the RPR static mesh components and material parsing, then render and readback.
+*
+* UE4Editor-Cmd.exe <Project> -run=RPRBenchmark [-Map=<Map>] [-Meshes=64] [-Instances=16] [-Materials=64]
+*		[-Textures=16] [-TextureSize=1024] [-Width=1920] [-Height=1080] [-Iterations=16] [-Output=<File.json>]
+*
+* Without -Map, a scene of engine basic shapes is spawned in the editor world (no project asset needed).
+* Stage timings and RPR call counts (RPR::ApiStats) are written to -Output (Saved/Profiling/RPRBenchmark.json by default)
+* so runs can be compared. Meant to be run with the mock backend (RPR_MOCK_BACKEND=1) on machines without a GPU.
+*/
+UCLASS()
+class URPRBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	URPRBenchmarkCommandlet();
+
+	virtual int32	Main(const FString &Params) override;
+};
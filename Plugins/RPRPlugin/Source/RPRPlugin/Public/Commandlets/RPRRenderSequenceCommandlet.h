@@ -0,0 +1,41 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "RPRRenderSequenceCommandlet.generated.h"
+
+/**
+* Renders an image sequence without the ProRender viewport.
+*
+* UE4Editor-Cmd.exe <Project> -run=RPRRenderSequence -Map=/Game/Maps/MyMap -Camera=CameraActor -Frames=120
+*		[-Output=<Directory>] [-Prefix=Frame] [-Format=png] [-FrameRate=24] [-Iterations=256] [-NoiseThreshold=0.05]
+*		[-Turntable=360] [-Pivot=X,Y,Z] [-Timeout=600]
+*
+* The RPR scene is built once and stays resident for the whole sequence.
+* Between frames, the world is ticked and only the transform/property changes are pushed to RPR.
+*/
+UCLASS()
+class URPRRenderSequenceCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+public:
+	URPRRenderSequenceCommandlet();
+
+	virtual int32	Main(const FString &Params) override;
+};
@@ -64,6 +64,10 @@ public:
 	void			SetAOV(RPR::EAOV AOVMode);
 	RPR::EAOV		GetAOV() const;
 
+	/* Normalized rectangle of the render texture to sample, an invalid box renders the full frame */
+	void			SetRegionOfInterest(const FBox2D &region);
+	const FBox2D	&GetRegionOfInterest() const { return m_RegionOfInterest; }
+
 	void			NotifyObjectBuilt();
 
 	class UTexture2DDynamic		*GetRenderTexture() { return m_RenderTexture; }
@@ -123,4 +127,5 @@ private:
 
 	bool					m_Loaded;
 	RPR::EAOV				m_AOVMode;
+	FBox2D					m_RegionOfInterest;
 };
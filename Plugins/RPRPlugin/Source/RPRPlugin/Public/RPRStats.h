@@ -34,3 +34,5 @@ DECLARE_CYCLE_STAT_EXTERN(TEXT("RPR Thread: Rebuild scene"), STAT_ProRender_Rebu
 DECLARE_CYCLE_STAT_EXTERN(TEXT("RPR Thread: Render"), STAT_ProRender_Render, STATGROUP_ProRender, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("RPR Thread: Resolve"), STAT_ProRender_Resolve, STATGROUP_ProRender, );
 DECLARE_CYCLE_STAT_EXTERN(TEXT("RPR Thread: Readback framebuffer"), STAT_ProRender_Readback, STATGROUP_ProRender, );
+
+DECLARE_MEMORY_STAT_EXTERN(TEXT("Build scratch high water"), STAT_ProRender_BuildScratchHighWater, STATGROUP_ProRender, );
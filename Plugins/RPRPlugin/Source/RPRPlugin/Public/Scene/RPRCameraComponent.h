@@ -50,6 +50,7 @@ private:
 	virtual bool	Build() override;
 	virtual bool	RebuildTransforms() override;
 	virtual void	TickComponent(float deltaTime, ELevelTick tickType, FActorComponentTickFunction *tickFunction) override;
+	virtual bool	NeedsTick() const override;
 	virtual bool	RPRThread_Update() override;
 	virtual void	ReleaseResources() override;
 
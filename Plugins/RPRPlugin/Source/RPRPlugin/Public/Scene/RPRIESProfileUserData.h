@@ -0,0 +1,38 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/AssetUserData.h"
+#include "RPRIESProfileUserData.generated.h"
+
+/**
+* Content of the .ies file a light profile texture was imported from.
+* UE4 only keeps the baked texture, RPR needs the original profile. The editor reads it from the source file when missing,
+* textures rendered by packaged builds need it saved with them. The plugin never adds it on its own, that would dirty the asset.
+*/
+UCLASS()
+class URPRIESProfileUserData : public UAssetUserData
+{
+	GENERATED_BODY()
+public:
+
+	// Null terminated, rprIESLightSetImageFromIESdata takes the file content as a C string
+	UPROPERTY()
+	TArray<uint8>	Profile;
+};
@@ -45,6 +45,9 @@ public:
 
 	virtual bool	Build() override;
 
+	/* Drops the IES profiles read from source files, called on scene teardown */
+	static void		ClearIESCache();
+
 private:
 
 	virtual void	ReleaseResources() override;
@@ -59,6 +62,18 @@ private:
 	int BuildDirectionalLight(const class UDirectionalLightComponent *dirLightComponent);
 	int BuildSkyLight(const class USkyLightComponent *skyLightComponent);
 
+	virtual bool	NeedsTick() const override;
+	bool	ShouldPollProperties() const;
+	void	MarkPropertiesDirty();
+
+	void	BindPropertyChangeEvents();
+	void	UnbindPropertyChangeEvents();
+
+	static void	OnSrcRenderStateDirty(UActorComponent &component);
+#if WITH_EDITOR
+	static void	OnSrcPropertyChanged(UObject *object, struct FPropertyChangedEvent &propertyChangedEvent);
+#endif
+
 private:
 
 	RPR::FImagePtr	m_RprImage;
@@ -75,4 +90,11 @@ private:
 
 	UTextureCube				*m_CachedCubemap;
 	ESkyLightSourceType			m_CachedSourceType;
+
+	// Lights are only checked after an edit was notified, unless ShouldPollProperties()
+	FThreadSafeBool				m_PropertiesDirty;
+
+	// Property edits are routed to the light watching the edited component only
+	static FCriticalSection									WatchedLightsLock;
+	static TMap<const UActorComponent*, URPRLightComponent*>	WatchedLights;
 };
@@ -50,6 +50,7 @@ public:
 	void	OnRender(uint32 &outObjectToBuildCount);
 	void	OnPause();
 	void	OnSave();
+	bool	RenderOfflineFrame(const FString &filename, float timeoutSeconds);
 	void	Rebuild();
 	void	SetTrace(bool trace);
 
@@ -69,6 +70,20 @@ public:
 	void	ApplyDenoiser();
 	uint32	GetRenderIteration() const;
 
+	/* False when adaptive sampling doesn't run, outSecondsLeft is negative while unknown */
+	bool	GetConvergence(float &outConvergedRatio, float &outSecondsLeft) const;
+
+	/* Wakes the RPR thread up so it picks up component changes, safe from any thread */
+	void	WakeRendererWorker();
+
+	/* Has the game thread call PrepareUpdate on the components while the RPR thread is parked, safe from any thread */
+	void	RequestPrepareUpdate();
+
+	void	UpdateRegionOfInterest();
+
+	/* Exports the RPR scene without blocking the editor, onCompleted is called on the game thread */
+	void	ExportToGLTF(const FString &filename, TFunction<void(bool)> onCompleted);
+
 	void	TriggerResize() { m_TriggerEndFrameResize = true; }
 	void	TriggerFrameRebuild() { m_TriggerEndFrameRebuild = true; }
 
@@ -82,6 +97,11 @@ private:
 	virtual bool	ShouldTickIfViewportsOnly() const override { return true; }
 
 	void	CheckPendingKills();
+	void	RemoveDeletedSources();
+	void	OnLevelActorDeleted(AActor *actor);
+#if WITH_EDITOR
+	void	OnObjectsReplaced(const TMap<UObject*, UObject*> &replacementMap);
+#endif
 	bool	ResizeRenderTarget();
 	void	RemoveSceneContent(bool clearScene, bool clearCache);
 	bool	QueueBuildRPRActor(UWorld *world, USceneComponent *srcComponent, UClass *typeClass, bool checkIfContained);
@@ -97,6 +117,12 @@ private:
 	bool	m_TriggerEndFrameResize;
 	bool	m_TriggerEndFrameRebuild;
 
+	// Set by the deletion events, the sources are looked up on the next Tick only
+	bool			m_SourcesDeleted;
+	double			m_LastDeletedSourcesSweep;
+	FDelegateHandle	m_LevelActorDeletedHandle;
+	FDelegateHandle	m_ObjectsReplacedHandle;
+
 	uint32	m_NumDevices;
 
 	TSharedPtr<class FRPRRendererWorker>	m_RendererWorker;
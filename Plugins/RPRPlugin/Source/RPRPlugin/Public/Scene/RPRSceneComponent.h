@@ -18,7 +18,10 @@
 
 #include "CoreMinimal.h"
 #include "Components/SceneComponent.h"
+#include "HAL/ThreadSafeBool.h"
 #include "RPRCoreErrorHelper.h"
+#include "Typedefs/RPRTypedefs.h"
+#include "Helpers/RPRScratchMemory.h"
 #include "RPRSceneComponent.generated.h"
 
 enum
@@ -41,6 +44,7 @@ enum
 	{															\
 		cachedValue = value;									\
 		m_RebuildFlags |= flag;									\
+		WakeRenderer();											\
 	}
 
 /**
@@ -67,9 +71,19 @@ public:
 	/* Rebuild the RPR transforms */
 	virtual bool	RebuildTransforms() { return false; }
 
+	/* Called on the Game thread while the RPR thread is parked, after RequestPrepareUpdate. Heavy work for the next RPRThread_Update goes here */
+	virtual void	PrepareUpdate() {}
+
 	/* Called on the RPR Thread, execute rpr calls to refresh object properties */
 	virtual bool	RPRThread_Update();
 
+	/*
+	* Called on the RPR Thread before RPRThread_Update.
+	* A pending transform rebuild that only needs rprShapeSetTransform can be handed over here instead,
+	* the scene then converts the transforms of all components in a single batch.
+	*/
+	virtual void	RPRThread_GatherShapeTransforms(RPR::ScratchMemory::TScratchArray<RPR::FShape>& OutShapes, RPR::ScratchMemory::TScratchArray<FTransform>& OutTransforms) {}
+
 	/** Safe call to release resources */
 	virtual void	ReleaseResources();
 
@@ -78,6 +92,19 @@ protected:
 	void			TickComponent(float deltaTime, ELevelTick tickType, FActorComponentTickFunction *tickFunction) override;
 	void			TriggerRebuildTransforms();
 
+	/* Ticking is disabled once this returns false, whoever flags a change turns it back on */
+	virtual bool	NeedsTick() const;
+
+	/* Call after setting m_RebuildFlags, the RPR thread only checks them when awake */
+	void			WakeRenderer();
+
+	/* Schedules PrepareUpdate, safe from any thread */
+	void			RequestPrepareUpdate();
+
+	/* Bound to SrcComponent->TransformUpdated, can be called from any thread */
+	void			OnSrcTransformUpdated(USceneComponent *updatedComponent, EUpdateTransformFlags updateTransformFlags, ETeleportType teleport);
+	void			UnbindSrcComponentEvents();
+
 	virtual void	BeginDestroy() override;
 protected:
 	bool					m_Built;
@@ -89,4 +116,6 @@ protected:
 	FCriticalSection		m_RefreshLock;
 private:
 	FTransform				m_CachedTransforms;
+	FThreadSafeBool			m_SrcTransformChanged;
+	FDelegateHandle			m_TransformUpdatedHandle;
 };
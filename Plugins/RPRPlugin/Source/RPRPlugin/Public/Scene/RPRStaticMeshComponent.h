@@ -41,6 +41,14 @@ enum
 	PROPERTY_MATERIALS_CHANGES = 0x200
 };
 
+/* Material of a slot, resolved on the game thread. The RPR thread only binds it to the shapes */
+struct FRPRPreparedMaterial
+{
+	RPR::FRPRXMaterialPtr		RprxMaterial;
+	RPR::FRPRXMaterialNodePtr	RprxNodeMaterial;
+	RPR::FMaterialNode			RawMaterial = nullptr; // nullptr detaches the current material
+};
+
 UCLASS(Transient)
 class URPRStaticMeshComponent : public URPRSceneComponent
 {
@@ -65,35 +73,50 @@ private:
 	bool					BuildMaterials();
 
 	virtual void	TickComponent(float deltaTime, ELevelTick tickType, FActorComponentTickFunction *tickFunction) override;
+	virtual bool	NeedsTick() const override;
 	virtual void	ReleaseResources() override;
 	virtual bool	PostBuild() override;
+	virtual void	PrepareUpdate() override;
 	virtual bool	RPRThread_Update() override;
+	virtual void	RPRThread_GatherShapeTransforms(RPR::ScratchMemory::TScratchArray<RPR::FShape>& OutShapes, RPR::ScratchMemory::TScratchArray<FTransform>& OutTransforms) override;
+
+	void	GatherShapeTransforms(RPR::ScratchMemory::TScratchArray<RPR::FShape>& OutShapes, RPR::ScratchMemory::TScratchArray<FTransform>& OutTransforms) const;
 
 	bool	UpdateDirtyMaterialsIFN();
-	bool	UpdateDirtyMaterialsChangesIFN();
+	bool	UpdateDirtyMaterialSlotsIFN();
 
-	void	BuildRPRMaterial(RPR::FShape& Shape, URPRMaterial* Material);
-	bool	ApplyRPRMaterialOnShape(RPR::FShape& Shape, URPRMaterial* Material);
+	FRPRPreparedMaterial	PrepareMaterial(UMaterialInterface* Material);
+	void	BindMaterialOnShape(FRPRShape& Shape, const FRPRPreparedMaterial& Material);
 	void	OnUsedMaterialChanged(URPRMaterial* Material);
 	void	ClearMaterialChangedWatching();
-	void	AttachDummyMaterial(RPR::FShape shape);
 	int		SetInstanceTransforms(class UInstancedStaticMeshComponent *instancedMeshComponent, RadeonProRender::matrix *componentMatrix, rpr_shape shape, uint32 instanceIndex);
 
-	void	WatchMaterialsChanges();
-	void	UpdateLastMaterialList();
+	void	DetectMaterialSlotChanges();
+	void	OnUsedMaterialEdited(UMaterialInterface* Material);
+	void	WatchMaterials();
+	void	UnwatchMaterials();
+	void	UpdateMaterialUsers(const TArray<UMaterialInterface*>& OldMaterials, const TArray<UMaterialInterface*>& NewMaterials);
 
-	RPR::FResult	DetachCurrentMaterial(RPR::FShape Shape);
-	FRPRShape*		FindShapeByMaterialIndex(int32 MaterialIndex);
+	static void		OnSrcRenderStateDirty(UActorComponent& Component);
+#if WITH_EDITOR
+	static void		OnObjectPropertyChanged(UObject* Object, struct FPropertyChangedEvent& PropertyChangedEvent);
+#endif
 
 	static TMap<UStaticMesh*, TArray<FRPRCachedMesh>>	Cache;
 
+	// Material edits and slot reassignments are routed to the components using them only
+	static FCriticalSection												MaterialUsersLock;
+	static TMultiMap<const UMaterialInterface*, URPRStaticMeshComponent*>	MaterialUsers;
+	static TMap<const UActorComponent*, URPRStaticMeshComponent*>		WatchedSrcComponents;
+
 	uint32				m_CachedInstanceCount;
 
 	TArray<FRPRShape>	m_Shapes;
-	TQueue<URPRMaterial*> m_dirtyMaterialsQueue;
+	TQueue<TWeakObjectPtr<URPRMaterial>> m_dirtyMaterialsQueue;
 
 	TArray<UMaterialInterface*> m_cachedMaterials;
-	TArray<UMaterialInterface*> m_lastMaterialsList;
+	TMap<int32, TWeakObjectPtr<UMaterialInterface>> m_DirtyMaterialSlots;
+	TMap<int32, FRPRPreparedMaterial> m_PreparedMaterialSlots;
 
 	FDelegateHandleManager<URPRMaterial> m_OnMaterialChangedDelegateHandles;
 };
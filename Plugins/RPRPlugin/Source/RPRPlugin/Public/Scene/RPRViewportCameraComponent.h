@@ -45,9 +45,13 @@ public:
 	FVector			GetCameraPosition() const;
 	float			GetAspectRatio() const;
 
+	/* FPlatformTime::Seconds() of the last tick that moved the camera */
+	double			GetLastMoveTime() const { return m_LastMoveTime; }
+
 private:
 	virtual void	RebuildCameraProperties(bool force);
 	virtual void	TickComponent(float deltaTime, ELevelTick tickType, FActorComponentTickFunction *tickFunction) override;
+	virtual bool	NeedsTick() const override;
 	virtual bool	RebuildTransforms() override;
 
 	void			UpdateOrbitCamera();
@@ -57,6 +61,7 @@ private:
 
 	FVector		m_CachedCameraPos;
 	FVector		m_CachedCameraLookAt;
+	double		m_LastMoveTime;
 
 	bool						m_CachedIsLocked;
 	ECameraProjectionMode::Type	m_CachedProjectionMode;
@@ -18,6 +18,7 @@
 
 #include <string>
 #include <string>
+#include <cstdint>
 #include <vector>
 #include <unordered_set>
 #include <unordered_map>
@@ -33,6 +34,7 @@ namespace rpr
 
 		void Clear();
 
+		// Parses the file again only if it changed since the last load
 		void LoadControlData(const std::string& filename);
 
 		bool IsMaterialUMSEnabled(const std::string& name);
@@ -41,5 +43,9 @@ namespace rpr
 
 		bool matchAll = false;
 		std::unordered_map<std::string, bool> materialEnables;
+
+		std::string loadedFilename;
+		int64_t loadedTimeStamp = 0;
+		int64_t loadedFileSize = -1;
 	};
 }
@@ -28,12 +28,11 @@ namespace RPR
 	class RPRCORE_API VirtualNode;
 }
 
-struct	FRPRShape;
-
 class URadeonMaterialParser
 {
 public:
-	void Process(FRPRShape& shape, UMaterialInterface* materialInterface);
+	/* Builds the uber material of a UE material, nullptr if it can't be converted. Call it on the game thread, the shapes are bound by the caller */
+	RPR::FRPRXMaterialNodePtr Parse(UMaterialInterface* materialInterface);
 
 private:
 
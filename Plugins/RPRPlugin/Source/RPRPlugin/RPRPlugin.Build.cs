@@ -71,6 +71,7 @@ public class RPRPlugin : ModuleRules
 				"RenderCore",
 				"CinematicCamera",
 				"RHI",
+				"ImageWrapper",
 
 				// ... add private dependencies that you statically link with here ...	
 			});
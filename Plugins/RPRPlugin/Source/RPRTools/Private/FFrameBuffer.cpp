@@ -15,6 +15,7 @@
 *************************************************************************/
 
 #include "FFrameBuffer.h"
+#include "Helpers/RPRMemoryReport.h"
 #include <Logging/LogMacros.h>
 
 #ifdef CHECK_ERROR
@@ -64,9 +65,16 @@ int FFrameBuffer::Create(rpr_context context, rpr_framebuffer_format const forma
 	status = Destroy();
 	CHECK_WARNING(status, TEXT("destroy has some problem"));
 
+	const FString source = FString::Printf(TEXT("Framebuffer %ux%u"), fb_desc->fb_width, fb_desc->fb_height);
+
 	status = rprContextCreateFrameBuffer(context, format, fb_desc, &FrameBuffer);
+	if (status != RPR_SUCCESS)
+		RPR::Memory::LogOutOfMemory(status, source);
 	CHECK_ERROR(status, TEXT("can't create framebuffer"));
 
+	RPR::Memory::Track(FrameBuffer, RPR::Memory::ECategory::FrameBuffer,
+		(int64)fb_desc->fb_width * fb_desc->fb_height * format.num_components * sizeof(float), source);
+
 	return RPR_SUCCESS;
 }
 
@@ -75,6 +83,8 @@ int FFrameBuffer::Destroy()
 	if (!FrameBuffer)
 		return RPR_SUCCESS;
 
+	RPR::Memory::Untrack(FrameBuffer);
+
 	int status;
 	status = rprObjectDelete(FrameBuffer);
 	CHECK_WARNING(status, TEXT("framebuffer object delete error"));
@@ -75,6 +75,7 @@ int FPostEffect::Destroy()
 	CHECK_WARNING(status, TEXT("can't destroy post effect"));
 
 	PostEffect = nullptr;
+	Parameters.Empty();
 
 	return RPR_SUCCESS;
 }
@@ -116,10 +117,17 @@ int FPostEffect::Detach(rpr_context context)
 int FPostEffect::SetFloat(const char* key, float value)
 {
 	int status;
+	unsigned int bits;
+
+	FMemory::Memcpy(&bits, &value, sizeof(bits));
+	if (IsParameterUnchanged(key, bits))
+		return RPR_SUCCESS;
 
 	status = rprPostEffectSetParameter1f(PostEffect, key, value);
 	CHECK_ERROR(status, TEXT("can't set post effect float parameter"));
 
+	Parameters.Add(key, bits);
+
 	return RPR_SUCCESS;
 }
 
@@ -127,10 +135,21 @@ int FPostEffect::SetUInt(const char* key, unsigned int value)
 {
 	int status;
 
+	if (IsParameterUnchanged(key, value))
+		return RPR_SUCCESS;
+
 	status = rprPostEffectSetParameter1u(PostEffect, key, value);
 	CHECK_ERROR(status, TEXT("can't set post effect uint parameter"));
 
+	Parameters.Add(key, value);
+
 	return RPR_SUCCESS;
 }
 
+bool FPostEffect::IsParameterUnchanged(const char* key, unsigned int bits) const
+{
+	const unsigned int* lastBits = Parameters.Find(key);
+	return lastBits != nullptr && *lastBits == bits;
+}
+
 } // namespace RPR
\ No newline at end of file
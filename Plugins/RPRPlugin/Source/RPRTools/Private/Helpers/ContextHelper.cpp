@@ -16,6 +16,7 @@
 
 #include "Helpers/ContextHelper.h"
 #include "Helpers/RPRShapeHelpers.h"
+#include "Helpers/RPRMemoryReport.h"
 #include "UObject/UObjectGlobals.h"
 #include "UObject/Class.h"
 #include "EngineMinimal.h"
@@ -117,6 +118,13 @@ namespace RPR
 			return status;
 		}
 
+		FResult RenderTile(FContext Context, uint32 MinX, uint32 MaxX, uint32 MinY, uint32 MaxY)
+		{
+			RPR::FResult status = rprContextRenderTile(Context, MinX, MaxX, MinY, MaxY);
+			UE_LOG(LogRPRTools_Step, Verbose, TEXT("rprContextRenderTile(context=%p, x=[%d, %d[, y=[%d, %d[) -> %d"), Context, MinX, MaxX, MinY, MaxY, status);
+			return status;
+		}
+
 		FResult ResolveFrameBuffer(FContext Context, FFrameBuffer& SrcFrameBuffer, FFrameBuffer& DstFrameBuffer, bool bShouldNormalizeOnly)
 		{
 			RPR::FResult status = rprContextResolveFrameBuffer(Context, SrcFrameBuffer.get(), DstFrameBuffer.get(), bShouldNormalizeOnly);
@@ -136,6 +144,16 @@ namespace RPR
 				TEXT("rprContextCreateInstance(context=%p, shape=%s) -> status=%d, instance=%p"),
 				Context, *RPR::Shape::GetName(Shape), status, OutShapeInstance);
 
+			// Instances are reported under their mesh, only the transform is stored per instance
+			if (RPR::IsResultSuccess(status))
+			{
+				RPR::Memory::Track(OutShapeInstance, RPR::Memory::ECategory::Instance, sizeof(float) * 16, RPR::Shape::GetName(Shape));
+			}
+			else
+			{
+				RPR::Memory::LogOutOfMemory(status, RPR::Shape::GetName(Shape));
+			}
+
 			return status;
 		}
 
@@ -152,29 +170,61 @@ namespace RPR
 		}
 
 		FResult CreateMesh(FContext Context, const TCHAR* MeshName,
-					const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<uint32>& Indices,
-					const TArray<FVector2D>& Texcoords, const TArray<uint32>& NumFaceVertices, FShape& OutMesh)
+					TArrayView<const FVector> Vertices, TArrayView<const FVector> Normals, TArrayView<const uint32> Indices,
+					TArrayView<const FVector2D> Texcoords, TArrayView<const uint32> NumFaceVertices, FShape& OutMesh)
+		{
+			return CreateMesh(Context, MeshName, Vertices, Indices, Normals, Indices, Texcoords, Indices, NumFaceVertices, OutMesh);
+		}
+
+		FResult CreateMesh(FContext Context, const TCHAR* MeshName,
+					TArrayView<const FVector> Vertices, TArrayView<const uint32> VertexIndices,
+					TArrayView<const FVector> Normals, TArrayView<const uint32> NormalIndices,
+					TArrayView<const FVector2D> Texcoords, TArrayView<const uint32> TexcoordIndices,
+					TArrayView<const uint32> NumFaceVertices, FShape& OutMesh)
 		{
+			check(NormalIndices.Num() == VertexIndices.Num() || Normals.Num() == 0);
+			check(TexcoordIndices.Num() == VertexIndices.Num() || Texcoords.Num() == 0);
+
 			RPR::FResult status = rprContextCreateMesh(Context,
 				(rpr_float const *) Vertices.GetData(),		Vertices.Num(),		sizeof(float) * 3,
 				(rpr_float const *) Normals.GetData(),		Normals.Num(),		sizeof(float) * 3,
 				(rpr_float const *) Texcoords.GetData(),	Texcoords.Num(),	sizeof(float) * 2,
-				(rpr_int const *) Indices.GetData(), sizeof(uint32),
-				(rpr_int const *) Indices.GetData(), sizeof(uint32),
-				(rpr_int const *) Indices.GetData(), sizeof(uint32),
+				(rpr_int const *) VertexIndices.GetData(), sizeof(uint32),
+				Normals.Num() > 0 ? (rpr_int const *) NormalIndices.GetData() : nullptr, sizeof(uint32),
+				Texcoords.Num() > 0 ? (rpr_int const *) TexcoordIndices.GetData() : nullptr, sizeof(uint32),
 				(rpr_int const *) NumFaceVertices.GetData(), NumFaceVertices.Num(),
 				&OutMesh);
 
 			UE_LOG(LogRPRTools_Step, VeryVerbose,
 				TEXT("rprContextCreateMesh(context=%p, verticesNum=%d, normalsNum=%d, texCoordsNum=%d, indicesNum=%d, numFaceVertices=%d) -> status=%d, mesh=%p"),
 				Context,
-				Vertices.Num(), Normals.Num(), Texcoords.Num(), Indices.Num(), NumFaceVertices.Num(),
+				Vertices.Num(), Normals.Num(), Texcoords.Num(), VertexIndices.Num(), NumFaceVertices.Num(),
 				status, OutMesh);
 
 			if (RPR::IsResultSuccess(status))
 			{
+				const int64	byteCount =
+					Vertices.Num() * sizeof(FVector) + Normals.Num() * sizeof(FVector) + Texcoords.Num() * sizeof(FVector2D) +
+					(VertexIndices.Num() + (Normals.Num() > 0 ? NormalIndices.Num() : 0) + (Texcoords.Num() > 0 ? TexcoordIndices.Num() : 0)) * sizeof(uint32) +
+					NumFaceVertices.Num() * sizeof(uint32);
+				RPR::Memory::Track(OutMesh, RPR::Memory::ECategory::Mesh, byteCount, MeshName);
+
+				RPR::Mesh::FCounts	counts;
+				counts.Vertices = Vertices.Num();
+				counts.Normals = Normals.Num();
+				counts.UVs = Texcoords.Num();
+				counts.VertexIndices = VertexIndices.Num();
+				counts.NormalIndices = Normals.Num() > 0 ? NormalIndices.Num() : 0;
+				counts.UVIndices = Texcoords.Num() > 0 ? TexcoordIndices.Num() : 0;
+				counts.Faces = NumFaceVertices.Num();
+				RPR::Mesh::RecordCounts(OutMesh, counts);
+
 				status = RPR::SetObjectName(OutMesh, MeshName);
 			}
+			else
+			{
+				RPR::Memory::LogOutOfMemory(status, MeshName);
+			}
 
 			return status;
 		}
@@ -18,7 +18,8 @@
 
 RPR::FResult RPR::Generic::GetObjectName(RPR::Generic::FGetInfoFunction GetInfoFunction, void* Source, FString& OutName)
 {
-	TArray<uint8> buffer;
+	// Names are short, keep them off the heap
+	TArray<uint8, TInlineAllocator<256>> buffer;
 	RPR::FResult status = GetInfoToArray(GetInfoFunction, Source, RPR_OBJECT_NAME, buffer);
 	if (RPR::IsResultSuccess(status))
 	{
@@ -0,0 +1,135 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#include "Helpers/RPRApiStats.h"
+#include "HAL/IConsoleManager.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRPRApiStats, Log, All)
+
+namespace
+{
+	using RPR::ApiStats::EFunction;
+
+	const int32		FunctionCount = (int32)EFunction::Count;
+
+	int64			GCalls[FunctionCount] = {};
+	int64			GCycles[FunctionCount] = {};
+	int64			GBytes[FunctionCount] = {};
+
+	const TCHAR*	GFunctionNames[FunctionCount] =
+	{
+#define RPR_API_STATS_NAME(Name) TEXT("rpr") TEXT(#Name),
+		RPR_API_STATS_FUNCTIONS(RPR_API_STATS_NAME)
+#undef RPR_API_STATS_NAME
+	};
+
+	void	DumpStats(const TArray<FString>& Args)
+	{
+		RPR::ApiStats::Dump(Args.Num() > 0 ? Args[0] : TEXT("time"));
+	}
+
+	FAutoConsoleCommand	GDumpStatsCommand(
+		TEXT("RPR.Api.Dump"),
+		TEXT("Logs how many times the main RPR entry points were called, how long they took and how much data they were given.\n")
+		TEXT("Usage: RPR.Api.Dump [time|calls|bytes|name]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&DumpStats)
+	);
+
+	FAutoConsoleCommand	GResetStatsCommand(
+		TEXT("RPR.Api.Reset"),
+		TEXT("Clears the RPR call statistics, for example before rebuilding a scene."),
+		FConsoleCommandDelegate::CreateStatic(&RPR::ApiStats::Reset)
+	);
+}
+
+namespace RPR
+{
+	namespace ApiStats
+	{
+		void	Record(EFunction Function, uint64 Cycles, int64 ByteCount)
+		{
+			const int32	index = (int32)Function;
+			FPlatformAtomics::InterlockedIncrement(&GCalls[index]);
+			FPlatformAtomics::InterlockedAdd(&GCycles[index], (int64)Cycles);
+			if (ByteCount != 0)
+			{
+				FPlatformAtomics::InterlockedAdd(&GBytes[index], ByteCount);
+			}
+		}
+
+		void	Reset()
+		{
+			for (int32 i = 0; i < FunctionCount; ++i)
+			{
+				FPlatformAtomics::InterlockedExchange(&GCalls[i], 0);
+				FPlatformAtomics::InterlockedExchange(&GCycles[i], 0);
+				FPlatformAtomics::InterlockedExchange(&GBytes[i], 0);
+			}
+		}
+
+		void	GetStats(TArray<FFunctionStats>& OutStats)
+		{
+			OutStats.Reset();
+			for (int32 i = 0; i < FunctionCount; ++i)
+			{
+				const int64	calls = FPlatformAtomics::AtomicRead(&GCalls[i]);
+				if (calls == 0)
+					continue;
+
+				FFunctionStats	stats;
+				stats.Name = GFunctionNames[i];
+				stats.Calls = calls;
+				stats.Seconds = FPlatformTime::ToSeconds64(FPlatformAtomics::AtomicRead(&GCycles[i]));
+				stats.Bytes = FPlatformAtomics::AtomicRead(&GBytes[i]);
+				OutStats.Add(stats);
+			}
+		}
+
+		void	Dump(const FString& SortMode)
+		{
+			TArray<FFunctionStats>	sorted;
+			GetStats(sorted);
+
+			if (SortMode == TEXT("calls"))
+			{
+				sorted.Sort([](const FFunctionStats& A, const FFunctionStats& B) { return A.Calls > B.Calls; });
+			}
+			else if (SortMode == TEXT("bytes"))
+			{
+				sorted.Sort([](const FFunctionStats& A, const FFunctionStats& B) { return A.Bytes > B.Bytes; });
+			}
+			else if (SortMode == TEXT("name"))
+			{
+				sorted.Sort([](const FFunctionStats& A, const FFunctionStats& B) { return FCString::Strcmp(A.Name, B.Name) < 0; });
+			}
+			else
+			{
+				sorted.Sort([](const FFunctionStats& A, const FFunctionStats& B) { return A.Seconds > B.Seconds; });
+			}
+
+#if !RPR_API_STATS
+			UE_LOG(LogRPRApiStats, Display, TEXT("RPR calls are not recorded in this configuration (RPR_API_STATS=0)"));
+#endif
+			UE_LOG(LogRPRApiStats, Display, TEXT("RPR calls, sorted by %s:"), *SortMode);
+			UE_LOG(LogRPRApiStats, Display, TEXT("%-40s %10s %12s %10s %12s"), TEXT("Function"), TEXT("Calls"), TEXT("Total ms"), TEXT("Avg us"), TEXT("MB"));
+			for (const FFunctionStats& stats : sorted)
+			{
+				UE_LOG(LogRPRApiStats, Display, TEXT("%-40s %10lld %12.2f %10.2f %12.2f"),
+					stats.Name, stats.Calls, stats.Seconds * 1000.0, stats.Seconds * 1000000.0 / stats.Calls, stats.Bytes / (1024.0 * 1024.0));
+			}
+		}
+	}
+}
@@ -0,0 +1,105 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#include "Helpers/RPRContextParameterCache.h"
+#include "Helpers/RPRHelpers.h"
+
+namespace RPR
+{
+	FResult	FContextParameterCache::Set1u(FContext Context, rpr_context_info Parameter, uint32 Value, EChange* OutChange)
+	{
+		if (OutChange != nullptr)
+		{
+			*OutChange = EChange::None;
+		}
+		if (IsUnchanged(Parameter, Value))
+		{
+			return RPR_SUCCESS;
+		}
+
+		const FResult	status = rprContextSetParameterByKey1u(Context, Parameter, Value);
+		if (IsResultFailed(status))
+		{
+			values.Remove(Parameter);
+			return status;
+		}
+
+		values.Add(Parameter, Value);
+		if (OutChange != nullptr)
+		{
+			*OutChange = RequiresRestart(Parameter) ? EChange::Restart : EChange::Display;
+		}
+		return status;
+	}
+
+	FResult	FContextParameterCache::Set1f(FContext Context, rpr_context_info Parameter, float Value, EChange* OutChange)
+	{
+		if (OutChange != nullptr)
+		{
+			*OutChange = EChange::None;
+		}
+
+		uint32	bits;
+		FMemory::Memcpy(&bits, &Value, sizeof(bits));
+		if (IsUnchanged(Parameter, bits))
+		{
+			return RPR_SUCCESS;
+		}
+
+		const FResult	status = rprContextSetParameterByKey1f(Context, Parameter, Value);
+		if (IsResultFailed(status))
+		{
+			values.Remove(Parameter);
+			return status;
+		}
+
+		values.Add(Parameter, bits);
+		if (OutChange != nullptr)
+		{
+			*OutChange = RequiresRestart(Parameter) ? EChange::Restart : EChange::Display;
+		}
+		return status;
+	}
+
+	void	FContextParameterCache::Reset()
+	{
+		values.Empty();
+	}
+
+	bool	FContextParameterCache::RequiresRestart(rpr_context_info Parameter)
+	{
+		switch (Parameter)
+		{
+			case RPR_CONTEXT_DISPLAY_GAMMA:
+			case RPR_CONTEXT_TONE_MAPPING_TYPE:
+			case RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_SENSITIVITY:
+			case RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_EXPOSURE:
+			case RPR_CONTEXT_TONE_MAPPING_PHOTO_LINEAR_FSTOP:
+			// Set by the render loop as the accumulation goes
+			case RPR_CONTEXT_ITERATIONS:
+			case RPR_CONTEXT_FRAMECOUNT:
+				return false;
+			default:
+				return true;
+		}
+	}
+
+	bool	FContextParameterCache::IsUnchanged(rpr_context_info Parameter, uint32 Bits) const
+	{
+		const uint32	*lastBits = values.Find(Parameter);
+		return lastBits != nullptr && *lastBits == Bits;
+	}
+}
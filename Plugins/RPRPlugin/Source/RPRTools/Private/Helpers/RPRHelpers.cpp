@@ -21,9 +21,12 @@
 #include "CubemapUnwrapUtils.h"
 #include "RprTools.h"
 #include "HAL/UnrealMemory.h"
+#include "Math/VectorRegister.h"
+#include "Async/ParallelFor.h"
 #include "Helpers/RPRErrorsHelpers.h"
 #include "Helpers/GenericGetInfo.h"
 #include "Helpers/RPRShapeHelpers.h"
+#include "Helpers/RPRMemoryReport.h"
 
 #include <stdexcept>
 
@@ -67,6 +70,51 @@ RadeonProRender::matrix	BuildMatrixWithScale(const FTransform &transform, float
 	return matrix;
 }
 
+namespace
+{
+	// Below this count, dispatching to the task graph costs more than the conversion itself
+	const int32	MatrixBatchSize = 1024;
+
+	void	BuildMatrixWithScaleVectorized(const FTransform& Transform, const VectorRegister& TranslationScale, RadeonProRender::matrix& OutMatrix)
+	{
+		// ToMatrixWithScale is vectorized. Converting to RPR swaps Y and Z on both sides of the matrix,
+		// which exchanges rows 1 and 2 and the Y and Z lanes of every row, then RPR expects the transpose.
+		const FMatrix	ueMatrix = Transform.ToMatrixWithScale();
+
+		FMatrix	swapped;
+		VectorStoreAligned(VectorSwizzle(VectorLoadAligned(ueMatrix.M[0]), 0, 2, 1, 3), swapped.M[0]);
+		VectorStoreAligned(VectorSwizzle(VectorLoadAligned(ueMatrix.M[2]), 0, 2, 1, 3), swapped.M[1]);
+		VectorStoreAligned(VectorSwizzle(VectorLoadAligned(ueMatrix.M[1]), 0, 2, 1, 3), swapped.M[2]);
+		VectorStoreAligned(VectorMultiply(VectorSwizzle(VectorLoadAligned(ueMatrix.M[3]), 0, 2, 1, 3), TranslationScale), swapped.M[3]);
+
+		float*	dst = &OutMatrix.m00;
+		for (int32 row = 0; row < 4; ++row)
+		{
+			for (int32 column = 0; column < 4; ++column)
+			{
+				dst[row * 4 + column] = swapped.M[column][row];
+			}
+		}
+	}
+}
+
+void	BuildMatricesWithScale(TArrayView<const FTransform> Transforms, TArrayView<RadeonProRender::matrix> OutMatrices, float translationScale)
+{
+	check(Transforms.Num() == OutMatrices.Num());
+
+	const VectorRegister	scale = MakeVectorRegister(translationScale, translationScale, translationScale, 1.0f);
+	const int32				batchCount = FMath::DivideAndRoundUp(Transforms.Num(), MatrixBatchSize);
+
+	ParallelFor(batchCount, [&Transforms, &OutMatrices, &scale](int32 iBatch)
+	{
+		const int32	end = FMath::Min(Transforms.Num(), (iBatch + 1) * MatrixBatchSize);
+		for (int32 i = iBatch * MatrixBatchSize; i < end; ++i)
+		{
+			BuildMatrixWithScaleVectorized(Transforms[i], scale, OutMatrices[i]);
+		}
+	}, batchCount == 1);
+}
+
 namespace RPR
 {
 
@@ -82,6 +130,9 @@ namespace RPR
 
 	FResult DeleteObject(void*& Object)
 	{
+		Memory::Untrack(Object);
+		Mesh::ForgetCounts(Object);
+
 		FResult status = rprObjectDelete(Object);
 		UE_LOG(LogRPRTools_Step, Verbose, TEXT("rprObjectDelete(object=%p) -> %d"), Object, status);
 		if (IsResultSuccess(status))
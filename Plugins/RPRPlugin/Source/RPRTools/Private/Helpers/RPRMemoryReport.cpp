@@ -0,0 +1,204 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#include "Helpers/RPRMemoryReport.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/ScopeLock.h"
+#include "Stats/Stats.h"
+#include "RadeonProRender.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRPRMemory, Log, All)
+
+DECLARE_STATS_GROUP(TEXT("ProRender Memory"), STATGROUP_ProRenderMemory, STATCAT_Advanced);
+
+DECLARE_MEMORY_STAT(TEXT("Meshes"), STAT_ProRenderMemory_Mesh, STATGROUP_ProRenderMemory);
+DECLARE_MEMORY_STAT(TEXT("Instances"), STAT_ProRenderMemory_Instance, STATGROUP_ProRenderMemory);
+DECLARE_MEMORY_STAT(TEXT("Images"), STAT_ProRenderMemory_Image, STATGROUP_ProRenderMemory);
+DECLARE_MEMORY_STAT(TEXT("Framebuffers"), STAT_ProRenderMemory_FrameBuffer, STATGROUP_ProRenderMemory);
+DECLARE_MEMORY_STAT(TEXT("Denoiser"), STAT_ProRenderMemory_Denoiser, STATGROUP_ProRenderMemory);
+
+namespace
+{
+	using RPR::Memory::ECategory;
+
+	struct FEntry
+	{
+		ECategory	Category;
+		int64		ByteCount;
+		FString		Source;
+	};
+
+	FCriticalSection				GEntriesLock;
+	TMap<const void*, FEntry>		GEntries;
+	int64							GTotals[(int32)ECategory::Count] = {};
+
+	const TCHAR*	GetCategoryName(ECategory Category)
+	{
+		switch (Category)
+		{
+		case ECategory::Mesh:			return TEXT("Mesh");
+		case ECategory::Instance:		return TEXT("Instance");
+		case ECategory::Image:			return TEXT("Image");
+		case ECategory::FrameBuffer:	return TEXT("FrameBuffer");
+		case ECategory::Denoiser:		return TEXT("Denoiser");
+		default:						return TEXT("Unknown");
+		}
+	}
+
+	void	UpdateStat(ECategory Category, int64 Delta)
+	{
+		GTotals[(int32)Category] += Delta;
+
+		switch (Category)
+		{
+		case ECategory::Mesh:			INC_MEMORY_STAT_BY(STAT_ProRenderMemory_Mesh, Delta); break;
+		case ECategory::Instance:		INC_MEMORY_STAT_BY(STAT_ProRenderMemory_Instance, Delta); break;
+		case ECategory::Image:			INC_MEMORY_STAT_BY(STAT_ProRenderMemory_Image, Delta); break;
+		case ECategory::FrameBuffer:	INC_MEMORY_STAT_BY(STAT_ProRenderMemory_FrameBuffer, Delta); break;
+		case ECategory::Denoiser:		INC_MEMORY_STAT_BY(STAT_ProRenderMemory_Denoiser, Delta); break;
+		default: break;
+		}
+	}
+
+	void	LogTotals(ELogVerbosity::Type Verbosity)
+	{
+		int64	total = 0;
+		for (int32 i = 0; i < (int32)ECategory::Count; ++i)
+		{
+			FMsg::Logf(__FILE__, __LINE__, LogRPRMemory.GetCategoryName(), Verbosity,
+				TEXT("  %-12s %10.2f MB"), GetCategoryName((ECategory)i), GTotals[i] / (1024.0 * 1024.0));
+			total += GTotals[i];
+		}
+		FMsg::Logf(__FILE__, __LINE__, LogRPRMemory.GetCategoryName(), Verbosity,
+			TEXT("  %-12s %10.2f MB"), TEXT("Total"), total / (1024.0 * 1024.0));
+	}
+
+	struct FSourceUsage
+	{
+		ECategory	Category;
+		FString		Source;
+		int64		ByteCount = 0;
+		int32		ObjectCount = 0;
+	};
+
+	void	DumpMemory(const TArray<FString>& Args)
+	{
+		const FString	sortMode = Args.Num() > 0 ? Args[0] : TEXT("size");
+		const int32		maxCount = Args.Num() > 1 ? FCString::Atoi(*Args[1]) : 20;
+
+		FScopeLock	lock(&GEntriesLock);
+
+		// Objects created from the same asset are reported together, a mesh with many instances is one line
+		TMap<FString, FSourceUsage>	usages;
+		for (const TPair<const void*, FEntry>& it : GEntries)
+		{
+			const FEntry&	entry = it.Value;
+			FSourceUsage&	usage = usages.FindOrAdd(FString::Printf(TEXT("%d|%s"), (int32)entry.Category, *entry.Source));
+			usage.Category = entry.Category;
+			usage.Source = entry.Source;
+			usage.ByteCount += entry.ByteCount;
+			++usage.ObjectCount;
+		}
+
+		TArray<FSourceUsage>	sorted;
+		usages.GenerateValueArray(sorted);
+
+		if (sortMode == TEXT("name"))
+		{
+			sorted.Sort([](const FSourceUsage& A, const FSourceUsage& B) { return A.Source < B.Source; });
+		}
+		else if (sortMode == TEXT("category"))
+		{
+			sorted.Sort([](const FSourceUsage& A, const FSourceUsage& B)
+			{
+				return A.Category != B.Category ? A.Category < B.Category : A.ByteCount > B.ByteCount;
+			});
+		}
+		else
+		{
+			sorted.Sort([](const FSourceUsage& A, const FSourceUsage& B) { return A.ByteCount > B.ByteCount; });
+		}
+
+		UE_LOG(LogRPRMemory, Display, TEXT("%d tracked RPR objects from %d sources, sorted by %s:"), GEntries.Num(), sorted.Num(), *sortMode);
+		for (int32 i = 0; i < sorted.Num() && i < maxCount; ++i)
+		{
+			const FSourceUsage&	usage = sorted[i];
+			UE_LOG(LogRPRMemory, Display, TEXT("  %10.2f MB  %-12s x%-5d %s"),
+				usage.ByteCount / (1024.0 * 1024.0), GetCategoryName(usage.Category), usage.ObjectCount, *usage.Source);
+		}
+		LogTotals(ELogVerbosity::Display);
+	}
+
+	FAutoConsoleCommand	GDumpMemoryCommand(
+		TEXT("RPR.Memory.Dump"),
+		TEXT("Logs the estimated memory held by RPR objects, grouped by source asset.\n")
+		TEXT("Usage: RPR.Memory.Dump [size|name|category] [Count]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&DumpMemory)
+	);
+}
+
+namespace RPR
+{
+	namespace Memory
+	{
+		void	Track(const void* Object, ECategory Category, int64 ByteCount, const FString& Source)
+		{
+			if (Object == nullptr)
+				return;
+
+			FScopeLock	lock(&GEntriesLock);
+
+			if (FEntry* previous = GEntries.Find(Object))
+			{
+				UpdateStat(previous->Category, -previous->ByteCount);
+			}
+			GEntries.Add(Object, FEntry{ Category, ByteCount, Source });
+			UpdateStat(Category, ByteCount);
+		}
+
+		void	Untrack(const void* Object)
+		{
+			if (Object == nullptr)
+				return;
+
+			FScopeLock	lock(&GEntriesLock);
+
+			FEntry	entry;
+			if (GEntries.RemoveAndCopyValue(Object, entry))
+			{
+				UpdateStat(entry.Category, -entry.ByteCount);
+			}
+		}
+
+		int64	GetTotal(ECategory Category)
+		{
+			FScopeLock	lock(&GEntriesLock);
+			return GTotals[(int32)Category];
+		}
+
+		void	LogOutOfMemory(FResult Status, const FString& Source)
+		{
+			if (Status != RPR_ERROR_OUT_OF_VIDEO_MEMORY && Status != RPR_ERROR_OUT_OF_SYSTEM_MEMORY)
+				return;
+
+			FScopeLock	lock(&GEntriesLock);
+
+			UE_LOG(LogRPRMemory, Error, TEXT("%s while creating %s, tracked RPR memory:"),
+				Status == RPR_ERROR_OUT_OF_VIDEO_MEMORY ? TEXT("Out of video memory") : TEXT("Out of system memory"), *Source);
+			LogTotals(ELogVerbosity::Error);
+		}
+	}
+}
@@ -18,6 +18,13 @@
 #include "Helpers/RPRHelpers.h"
 #include "Helpers/GenericGetInfo.h"
 #include "Math/UnrealMathUtility.h"
+#include "Misc/ScopeLock.h"
+
+namespace
+{
+	FCriticalSection						GMeshCountsLock;
+	TMap<const void*, RPR::Mesh::FCounts>	GMeshCounts;
+}
 
 namespace RPR
 {
@@ -29,12 +36,57 @@ namespace RPR
 			return RPR::Generic::GetInfoNoAlloc(rprMeshGetInfo, Shape, Info, OutValue);
 		}
 
+		// Counts are size_t on some SDK versions, read them into 64 bits so the query never writes past the value
+		RPR::FResult GetCount(RPR::FShape Shape, RPR::EMeshInfo Info, uint32& OutCount)
+		{
+			uint64 count = 0;
+			RPR::FResult status = GetInfoNoAlloc(Shape, Info, &count);
+			if (RPR::IsResultSuccess(status) && count > MAX_uint32)
+			{
+				OutCount = 0;
+				return RPR_ERROR_INVALID_PARAMETER;
+			}
+			OutCount = (uint32) count;
+			return status;
+		}
+
 		template<typename T>
 		RPR::FResult GetInfoToArray(RPR::FShape Shape, RPR::EMeshInfo Info, TArray<T>& OutValue)
 		{
 			return (RPR::Generic::GetInfoToArray(rprMeshGetInfo, Shape, Info, OutValue));
 		}
 
+		template<typename T>
+		RPR::FResult GetInfoToArray(RPR::FShape Shape, RPR::EMeshInfo Info, uint32 Count, TArray<T>& OutValue)
+		{
+			return (RPR::Generic::GetInfoToArray(rprMeshGetInfo, Shape, Info, (int32) Count, OutValue));
+		}
+
+		//////////////////////////////////////////////////////////////////////////
+
+		void RecordCounts(RPR::FShape Mesh, const FCounts& Counts)
+		{
+			FScopeLock lock(&GMeshCountsLock);
+			GMeshCounts.Add(Mesh, Counts);
+		}
+
+		void ForgetCounts(const void* Object)
+		{
+			FScopeLock lock(&GMeshCountsLock);
+			GMeshCounts.Remove(Object);
+		}
+
+		bool FindCounts(RPR::FShape Mesh, FCounts& OutCounts)
+		{
+			FScopeLock lock(&GMeshCountsLock);
+			if (const FCounts* counts = GMeshCounts.Find(Mesh))
+			{
+				OutCounts = *counts;
+				return true;
+			}
+			return false;
+		}
+
 		//////////////////////////////////////////////////////////////////////////
 
 		RPR::FResult GetVertices(RPR::FShape Shape, TArray<FVector>& OutVertices)
@@ -42,9 +94,14 @@ namespace RPR
 			return GetInfoToArray(Shape, RPR::EMeshInfo::VertexArray, OutVertices);
 		}
 
+		RPR::FResult GetVertices(RPR::FShape Shape, uint32 VerticesCount, TArray<FVector>& OutVertices)
+		{
+			return GetInfoToArray(Shape, RPR::EMeshInfo::VertexArray, VerticesCount, OutVertices);
+		}
+
 		RPR::FResult GetVerticesCount(RPR::FShape Shape, uint32& OutVerticesCount)
 		{
-			return GetInfoNoAlloc(Shape, RPR::EMeshInfo::VertexCount, &OutVerticesCount);
+			return GetCount(Shape, RPR::EMeshInfo::VertexCount, OutVerticesCount);
 		}
 
 		RPR::FResult GetVertexIndexes(RPR::FShape Shape, TArray<uint32>& OutVerticesIndexes)
@@ -52,6 +109,11 @@ namespace RPR
 			return GetInfoToArray(Shape, RPR::EMeshInfo::VertexIndexArray, OutVerticesIndexes);
 		}
 
+		RPR::FResult GetVertexIndexes(RPR::FShape Shape, uint32 IndicesCount, TArray<uint32>& OutVerticesIndexes)
+		{
+			return GetInfoToArray(Shape, RPR::EMeshInfo::VertexIndexArray, IndicesCount, OutVerticesIndexes);
+		}
+
 		RPR::FResult GetVerticesIndexesStride(RPR::FShape Shape, uint32& OutStride)
 		{
 			return GetInfoNoAlloc(Shape, EMeshInfo::VertexIndexStride, &OutStride);
@@ -64,9 +126,14 @@ namespace RPR
 			return GetInfoToArray(Shape, RPR::EMeshInfo::NormalArray, OutNormals);
 		}
 
+		RPR::FResult GetNormals(RPR::FShape Shape, uint32 NormalsCount, TArray<FVector>& OutNormals)
+		{
+			return GetInfoToArray(Shape, RPR::EMeshInfo::NormalArray, NormalsCount, OutNormals);
+		}
+
 		RPR::FResult GetNormalsCount(RPR::FShape Shape, uint32& OutNormalsCount)
 		{
-			return GetInfoNoAlloc(Shape, RPR::EMeshInfo::NormalCount, &OutNormalsCount);
+			return GetCount(Shape, RPR::EMeshInfo::NormalCount, OutNormalsCount);
 		}
 
 		RPR::FResult GetNormalsIndexes(RPR::FShape Shape, TArray<uint32>& OutNormalsIndexes)
@@ -74,6 +141,11 @@ namespace RPR
 			return GetInfoToArray(Shape, RPR::EMeshInfo::NormalIndexArray, OutNormalsIndexes);
 		}
 
+		RPR::FResult GetNormalsIndexes(RPR::FShape Shape, uint32 IndicesCount, TArray<uint32>& OutNormalsIndexes)
+		{
+			return GetInfoToArray(Shape, RPR::EMeshInfo::NormalIndexArray, IndicesCount, OutNormalsIndexes);
+		}
+
 		RPR::FResult GetNormalsIndexesStride(RPR::FShape Shape, uint32& OutStride)
 		{
 			return GetInfoNoAlloc(Shape, EMeshInfo::NormalIndexStride, &OutStride);
@@ -88,11 +160,18 @@ namespace RPR
 			return GetInfoToArray(Shape, meshInfo, OutUVs);
 		}
 
+		RPR::FResult GetUV(RPR::FShape Shape, uint32 UVChannel, uint32 UVsCount, TArray<FVector2D>& OutUVs)
+		{
+			UVChannel = FMath::Clamp<uint32>(UVChannel, 0, 1);
+			RPR::EMeshInfo meshInfo = UVChannel == 0 ? RPR::EMeshInfo::UVArray : RPR::EMeshInfo::UV2Array;
+			return GetInfoToArray(Shape, meshInfo, UVsCount, OutUVs);
+		}
+
 		RPR::FResult GetUVCount(RPR::FShape Shape, uint32 UVChannel, uint32& OutUVsCount)
 		{
 			UVChannel = FMath::Clamp<uint32>(UVChannel, 0, 1);
 			RPR::EMeshInfo meshInfo = UVChannel == 0 ? RPR::EMeshInfo::UVCount : RPR::EMeshInfo::UV2Count;
-			return GetInfoNoAlloc(Shape, meshInfo, &OutUVsCount);
+			return GetCount(Shape, meshInfo, OutUVsCount);
 		}
 
 		RPR::FResult GetNumUV(RPR::FShape Shape, uint32& OutNumUVChannels)
@@ -100,6 +179,16 @@ namespace RPR
 			return GetInfoNoAlloc(Shape, EMeshInfo::UVDimensions, &OutNumUVChannels);
 		}
 
+		RPR::FResult GetUVsIndexes(RPR::FShape Shape, TArray<uint32>& OutUVsIndexes)
+		{
+			return GetInfoToArray(Shape, RPR::EMeshInfo::UVIndexArray, OutUVsIndexes);
+		}
+
+		RPR::FResult GetUVsIndexes(RPR::FShape Shape, uint32 IndicesCount, TArray<uint32>& OutUVsIndexes)
+		{
+			return GetInfoToArray(Shape, RPR::EMeshInfo::UVIndexArray, IndicesCount, OutUVsIndexes);
+		}
+
 		RPR::FResult GetUVsIndexesStride(RPR::FShape Shape, uint32& OutStride)
 		{
 			return GetInfoNoAlloc(Shape, EMeshInfo::UVIndexStride, &OutStride);
@@ -112,6 +201,11 @@ namespace RPR
 			return GetInfoToArray(Shape, EMeshInfo::NumFaceVerticesArray, OutNumFaceVertices);
 		}
 
+		RPR::FResult GetNumFaceVertices(RPR::FShape Shape, uint32 FacesCount, TArray<uint32>& OutNumFaceVertices)
+		{
+			return GetInfoToArray(Shape, EMeshInfo::NumFaceVerticesArray, FacesCount, OutNumFaceVertices);
+		}
+
 	} // namespace Mesh
 
 } // namespace RPR
\ No newline at end of file
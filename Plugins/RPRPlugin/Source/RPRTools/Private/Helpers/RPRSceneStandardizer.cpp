@@ -103,7 +103,10 @@ namespace RPR
 			return;
 		}
 
-		TMap<FShape, FMeshData> meshDataCache;
+		// Gather instances first, RPR calls stay on this thread
+		const float translationScale = RPR::Constants::SceneTranslationScaleFromRPRToUE4 * (1.0f / RPR::Constants::CentimetersInMeter);
+		TArray<FInstanceData> instances;
+		instances.Reserve(allShapes.Num());
 		for (int32 shapeInstancesIdx = 0; shapeInstancesIdx < allShapes.Num(); ++shapeInstancesIdx)
 		{
 			FShape shape = allShapes[shapeInstancesIdx];
@@ -124,8 +127,9 @@ namespace RPR
 				continue;
 			}
 
-			FShape meshShape;
-			status = RPR::Shape::GetInstanceBaseShape(shape, meshShape);
+			FInstanceData instance;
+			instance.Instance = shape;
+			status = RPR::Shape::GetInstanceBaseShape(shape, instance.MeshShape);
 			if (RPR::IsResultFailed(status))
 			{
 				UE_LOG(LogRPRSceneStandardizer, Warning,
@@ -134,103 +138,145 @@ namespace RPR
 				continue;
 			}
 
-			FMeshData* meshDataPtr = FindOrCacheMeshShape(meshDataCache, shape, meshShape);
-			check(meshDataPtr);
-			
-			// Create the mesh
-			status = RPR::Context::CreateMesh(Context, 
-				*RPR::Shape::GetName(shape), 
-				meshDataPtr->Vertices, 
-				meshDataPtr->Normals,
-				meshDataPtr->Indices,
-				meshDataPtr->TexCoords,
-				meshDataPtr->NumFacesVertices,
-				meshShape);
-
+			status = RPR::Shape::GetWorldTransform(shape, instance.Transform);
 			if (RPR::IsResultFailed(status))
 			{
-				UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot create mesh for shape instance %s"),
+				UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot get the transform of shape '%s'"),
 					*RPR::Shape::GetName(shape));
+				continue;
+			}
+			instance.Transform.ScaleTranslation(translationScale);
+
+			// Materials are assigned per component, so per instance. Fallback on the mesh one
+			instance.Material = nullptr;
+			if (RPR::IsResultFailed(RPR::Shape::GetMaterial(shape, instance.Material)) || instance.Material == nullptr)
+				RPR::Shape::GetMaterial(instance.MeshShape, instance.Material);
 
-				RPR::DeleteObject(meshShape);
+			instances.Add(instance);
+		}
+
+		// Instances reference a single standardized mesh per source mesh instead of duplicating its geometry
+		TMap<FShape, FShape> standardizedMeshes;
+		FMeshData meshData;
+		for (const FInstanceData& instance : instances)
+		{
+			FShape* meshShapePtr = standardizedMeshes.Find(instance.MeshShape);
+			if (meshShapePtr == nullptr)
+			{
+				meshShapePtr = &standardizedMeshes.Add(instance.MeshShape, CreateStandardizedMesh(Context, DstScene, instance.MeshShape, meshData));
+			}
+			if (*meshShapePtr == nullptr)
+			{
+				// Already reported when the mesh failed
+				continue;
+			}
+
+			const FString instanceName = RPR::Shape::GetName(instance.Instance);
+
+			FShape newInstance;
+			status = RPR::Context::CreateInstance(Context, *meshShapePtr, instanceName, newInstance);
+			if (RPR::IsResultFailed(status))
+			{
+				UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot create instance for shape instance %s"), *instanceName);
 				continue;
 			}
 
 			// Add the material
-			if (meshDataPtr->Material != nullptr)
+			if (instance.Material != nullptr)
 			{
-				status = rprShapeSetMaterial(meshShape, meshDataPtr->Material);
+				status = rprShapeSetMaterial(newInstance, instance.Material);
 				if (RPR::IsResultFailed(status))
 				{
 					UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot set material %p on shape instance %s"),
-						meshDataPtr->Material,
-						*RPR::Shape::GetName(shape));
+						instance.Material,
+						*instanceName);
 				}
 			}
-			
+
 			// Attach the shape to the scene
-			status = RPR::Scene::AttachShape(DstScene, meshShape);
+			status = RPR::Scene::AttachShape(DstScene, newInstance);
 			if (RPR::IsResultFailed(status))
 			{
-				UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot attach new shape %s to the scene"),
-					*RPR::Shape::GetName(shape));
+				UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot attach new shape %s to the scene"), *instanceName);
 
-				RPR::DeleteObject(meshShape);
+				RPR::DeleteObject(newInstance);
 				continue;
 			}
 
-			// Copy the transform and re-scale it correctly
-			FTransform transform;
-			status = RPR::Shape::GetWorldTransform(shape, transform);
-			transform.ScaleTranslation(RPR::Constants::SceneTranslationScaleFromRPRToUE4 * (1.0f / RPR::Constants::CentimetersInMeter));
-			status |= RPR::Shape::SetTransform(meshShape, transform);
-
+			status = RPR::Shape::SetTransform(newInstance, instance.Transform);
 			if (RPR::IsResultFailed(status))
 			{
-				UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot get/set the shape transform"),
-					*RPR::Shape::GetName(shape));
-
-				RPR::DeleteObject(meshShape);
-				continue;
+				UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot set the transform of shape %s"), *instanceName);
 			}
 		}
 	}
 
-	RPR::FSceneStandardizer::FMeshData* FSceneStandardizer::FindOrCacheMeshShape(
-		TMap<FShape, FMeshData>& MeshDataCache, 
-		FShape ShapeInstance, FShape MeshShape)
+	FShape FSceneStandardizer::CreateStandardizedMesh(RPR::FContext Context, RPR::FScene DstScene, FShape MeshShape, FMeshData& MeshData)
 	{
-		FMeshData* meshDataPtr = MeshDataCache.Find(MeshShape);
-		if (meshDataPtr == nullptr)
+		RPR::FResult status;
+		const FString meshName = RPR::Shape::GetName(MeshShape);
+
+		// Meshes created through RPR::Context::CreateMesh have their counts recorded, each array is then read in a single query.
+		// Others fall back on a size query per array
+		RPR::Mesh::FCounts counts;
+		const bool bReadFailed = RPR::Mesh::FindCounts(MeshShape, counts) ?
+			RPR::IsResultFailed(RPR::Mesh::GetVertices(MeshShape, counts.Vertices, MeshData.Vertices)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetNormals(MeshShape, counts.Normals, MeshData.Normals)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetVertexIndexes(MeshShape, counts.VertexIndices, MeshData.Indices)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetNormalsIndexes(MeshShape, counts.NormalIndices, MeshData.NormalIndices)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetUV(MeshShape, 0, counts.UVs, MeshData.TexCoords)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetUVsIndexes(MeshShape, counts.UVIndices, MeshData.TexCoordIndices)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetNumFaceVertices(MeshShape, counts.Faces, MeshData.NumFacesVertices))
+			:
+			RPR::IsResultFailed(RPR::Mesh::GetVertices(MeshShape, MeshData.Vertices)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetNormals(MeshShape, MeshData.Normals)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetVertexIndexes(MeshShape, MeshData.Indices)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetNormalsIndexes(MeshShape, MeshData.NormalIndices)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetUV(MeshShape, 0, MeshData.TexCoords)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetUVsIndexes(MeshShape, MeshData.TexCoordIndices)) ||
+			RPR::IsResultFailed(RPR::Mesh::GetNumFaceVertices(MeshShape, MeshData.NumFacesVertices));
+		if (bReadFailed)
 		{
-			RPR::FResult status;
-
-			FMeshData& meshData = MeshDataCache.Add(MeshShape);
-			status = RPR::Mesh::GetVertices(MeshShape, meshData.Vertices);
-			if (RPR::IsResultFailed(status)) return nullptr;
-
-			status = RPR::Mesh::GetNormals(MeshShape, meshData.Normals);
-			if (RPR::IsResultFailed(status)) return nullptr;
-
-			status = RPR::Mesh::GetVertexIndexes(MeshShape, meshData.Indices);
-			if (RPR::IsResultFailed(status)) return nullptr;
+			UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot read mesh data of %s"), *meshName);
+			return nullptr;
+		}
 
-			status = RPR::Mesh::GetUV(MeshShape, 0, meshData.TexCoords);
-			if (RPR::IsResultFailed(status)) return nullptr;
+		// Welded meshes index their normals and UVs separately from the positions, streams read without indices reuse the vertex ones
+		if (MeshData.Normals.Num() > 0 && MeshData.NormalIndices.Num() != MeshData.Indices.Num())
+			MeshData.NormalIndices = MeshData.Indices;
+		if (MeshData.TexCoords.Num() > 0 && MeshData.TexCoordIndices.Num() != MeshData.Indices.Num())
+			MeshData.TexCoordIndices = MeshData.Indices;
+
+		ScaleVectors(MeshData.Vertices, RPR::Constants::SceneTranslationScaleFromRPRToUE4 * (1.0f / RPR::Constants::CentimetersInMeter));
+
+		FShape newMesh;
+		status = RPR::Context::CreateMesh(Context,
+			*meshName,
+			MeshData.Vertices,
+			MeshData.Indices,
+			MeshData.Normals,
+			MeshData.NormalIndices,
+			MeshData.TexCoords,
+			MeshData.TexCoordIndices,
+			MeshData.NumFacesVertices,
+			newMesh);
 
-			status = RPR::Mesh::GetNumFaceVertices(MeshShape, meshData.NumFacesVertices);
-			if (RPR::IsResultFailed(status)) return nullptr;
+		if (RPR::IsResultFailed(status))
+		{
+			UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot create mesh %s"), *meshName);
+			return nullptr;
+		}
 
-			size_t dataSize;
-			status = rprShapeGetInfo(MeshShape, RPR_SHAPE_MATERIAL, sizeof(rpr_material_node), meshData.Material, &dataSize);
-			if (RPR::IsResultFailed(status)) return nullptr;
-			
-			ScaleVectors(meshData.Vertices, RPR::Constants::SceneTranslationScaleFromRPRToUE4 * (1.0f / RPR::Constants::CentimetersInMeter));
+		status = rprShapeSetVisibility(newMesh, false);
+		status |= RPR::Scene::AttachShape(DstScene, newMesh);
+		if (RPR::IsResultFailed(status))
+		{
+			UE_LOG(LogRPRSceneStandardizer, Warning, TEXT("Cannot attach mesh %s to the scene"), *meshName);
 
-			meshDataPtr = MeshDataCache.Find(MeshShape);
+			RPR::DeleteObject(newMesh);
+			return nullptr;
 		}
-
-		return meshDataPtr;
+		return newMesh;
 	}
 
 	void FSceneStandardizer::CopyAllLights(RPR::FContext Context, RPR::FScene SrcScene, RPR::FScene DstScene)
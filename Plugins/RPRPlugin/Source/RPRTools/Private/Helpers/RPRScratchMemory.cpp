@@ -0,0 +1,51 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#include "Helpers/RPRScratchMemory.h"
+#include "HAL/PlatformAtomics.h"
+
+namespace RPR
+{
+	namespace ScratchMemory
+	{
+		static volatile int64	GHighWaterMark = 0;
+
+		void	TrackUsage()
+		{
+			const int64	usage = FMemStack::Get().GetByteCount();
+
+			// Images are converted on the game thread while meshes build on the RPR thread
+			int64	highWaterMark = GHighWaterMark;
+			while (usage > highWaterMark)
+			{
+				const int64	previous = FPlatformAtomics::InterlockedCompareExchange(&GHighWaterMark, usage, highWaterMark);
+				if (previous == highWaterMark)
+					break;
+				highWaterMark = previous;
+			}
+		}
+
+		int64	GetHighWaterMark()
+		{
+			return FPlatformAtomics::AtomicRead(&GHighWaterMark);
+		}
+
+		void	ResetHighWaterMark()
+		{
+			FPlatformAtomics::InterlockedExchange(&GHighWaterMark, 0);
+		}
+	}
+}
@@ -15,6 +15,7 @@
 *************************************************************************/
 
 #include "Helpers/RPRTextureHelpers.h"
+#include "Helpers/RPRScratchMemory.h"
 
 #include "gli/texture2d.hpp"
 #include "gli/convert.hpp"
@@ -54,11 +55,14 @@ void RPR::FTextureHelpers::ConvertDxtTexture(const uint8* textureData, const uin
 	*(dxtHeaderBlank.data() + 5) = textureDataSize;
 	*(dxtHeaderBlank.data() + 21) = *(reinterpret_cast<const uint32*>(fourCC));
 
-	std::vector<char> restoredTexture(textureDataSize + 128);
-	memcpy(restoredTexture.data(), dxtHeaderBlank.data(), 128);
-	memcpy(restoredTexture.data() + 128, textureData, textureDataSize);
+	FMemMark	mark(FMemStack::Get());
+	RPR::ScratchMemory::TScratchArray<char>	restoredTexture;
+	restoredTexture.SetNumUninitialized(textureDataSize + 128);
+	memcpy(restoredTexture.GetData(), dxtHeaderBlank.data(), 128);
+	memcpy(restoredTexture.GetData() + 128, textureData, textureDataSize);
+	RPR::ScratchMemory::TrackUsage();
 
-	gli::texture dxtCompressed = gli::load(restoredTexture.data(), restoredTexture.size());
+	gli::texture dxtCompressed = gli::load(restoredTexture.GetData(), restoredTexture.Num());
 	assert(dxtCompressed.empty());
 	gli::texture2d dxtTexture2d(dxtCompressed);
 	assert(dxtTexture2d.empty());
@@ -72,7 +76,7 @@ void RPR::FTextureHelpers::ConvertDxtTexture(const uint8* textureData, const uin
 }
 
 
-bool RPR::FTextureHelpers::CopyTexture(const uint8* TextureData, const uint32 TextureDataSize, const RPR::FImageDesc& ImageDesc, TArray<uint8> &OutData, EPixelFormat PixelFormat, bool bUseSRGB)
+bool RPR::FTextureHelpers::CopyTexture(const uint8* TextureData, const uint32 TextureDataSize, const RPR::FImageDesc& ImageDesc, TArrayView<uint8> OutData, EPixelFormat PixelFormat, bool bUseSRGB)
 {
 	const float width = ImageDesc.image_width;
 	const float height = ImageDesc.image_height;
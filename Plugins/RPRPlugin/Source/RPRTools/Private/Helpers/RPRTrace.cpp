@@ -0,0 +1,230 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+
+#include "Helpers/RPRTrace.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformProcess.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformTLS.h"
+#include "HAL/ThreadManager.h"
+#include "HAL/ThreadSafeBool.h"
+#include "HAL/ThreadSafeCounter.h"
+#include "Misc/DateTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/ScopeLock.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogRPRTrace, Log, All)
+
+namespace
+{
+	const int32	EventsPerThread = 16384;
+
+	struct FTraceEvent
+	{
+		// Odd while the owning thread writes the event
+		FThreadSafeCounter	m_Sequence;
+		const TCHAR*		m_Name;
+		TCHAR				m_Detail[RPR::Trace::FScopedEvent::DetailLength];
+		uint64				m_StartCycles;
+		uint64				m_EndCycles;
+	};
+
+	struct FThreadBuffer
+	{
+		uint32				m_ThreadId;
+		FThreadSafeCounter	m_WriteCount;
+		TArray<FTraceEvent>	m_Events;
+
+		FThreadBuffer(uint32 threadId)
+			: m_ThreadId(threadId)
+		{
+			m_Events.SetNum(EventsPerThread);
+		}
+	};
+
+	FThreadSafeBool							traceEnabled(false);
+	FCriticalSection						threadBuffersLock;
+	TArray<TUniquePtr<FThreadBuffer>>		threadBuffers;
+	thread_local FThreadBuffer*				currentThreadBuffer = nullptr;
+
+	FThreadBuffer&	GetThreadBuffer()
+	{
+		if (currentThreadBuffer == nullptr)
+		{
+			// Only taken once per thread, buffers live until shutdown so that exited threads can still be dumped
+			FScopeLock lock(&threadBuffersLock);
+			threadBuffers.Add(MakeUnique<FThreadBuffer>(FPlatformTLS::GetCurrentThreadId()));
+			currentThreadBuffer = threadBuffers.Last().Get();
+		}
+		return *currentThreadBuffer;
+	}
+
+	FString	EscapeJson(const TCHAR* Str)
+	{
+		FString	result;
+		for (; Str != nullptr && *Str != 0; ++Str)
+		{
+			switch (*Str)
+			{
+			case TEXT('"'):		result += TEXT("\\\""); break;
+			case TEXT('\\'):	result += TEXT("\\\\"); break;
+			case TEXT('\n'):	result += TEXT("\\n"); break;
+			case TEXT('\t'):	result += TEXT("\\t"); break;
+			default:
+				if (*Str < 0x20)
+					result += FString::Printf(TEXT("\\u%04x"), (uint32) *Str);
+				else
+					result.AppendChar(*Str);
+				break;
+			}
+		}
+		return result;
+	}
+
+	FAutoConsoleCommand	startTraceCommand(
+		TEXT("RPR.Trace.Start"),
+		TEXT("Start recording the ProRender timeline"),
+		FConsoleCommandDelegate::CreateLambda([]() { RPR::Trace::SetEnabled(true); }));
+
+	FAutoConsoleCommand	stopTraceCommand(
+		TEXT("RPR.Trace.Stop"),
+		TEXT("Stop recording the ProRender timeline"),
+		FConsoleCommandDelegate::CreateLambda([]() { RPR::Trace::SetEnabled(false); }));
+
+	FAutoConsoleCommand	dumpTraceCommand(
+		TEXT("RPR.Trace.Dump"),
+		TEXT("Write the recorded ProRender timeline as a Chrome trace. Usage: RPR.Trace.Dump [Filename]"),
+		FConsoleCommandWithArgsDelegate::CreateLambda([](const TArray<FString>& Args)
+		{
+			const FString filename = Args.Num() > 0 ? Args[0] :
+				FPaths::Combine(FPaths::ProfilingDir(), FString::Printf(TEXT("RPRTrace-%s.json"), *FDateTime::Now().ToString()));
+			RPR::Trace::Dump(filename);
+		}));
+}
+
+namespace RPR
+{
+	namespace Trace
+	{
+
+		void SetEnabled(bool bEnabled)
+		{
+			traceEnabled = bEnabled;
+			UE_LOG(LogRPRTrace, Log, TEXT("ProRender trace %s"), bEnabled ? TEXT("started") : TEXT("stopped"));
+		}
+
+		bool IsEnabled()
+		{
+			return traceEnabled;
+		}
+
+		bool Dump(const FString& Filename)
+		{
+			TArray<FThreadBuffer*> buffers;
+			{
+				FScopeLock lock(&threadBuffersLock);
+				for (const TUniquePtr<FThreadBuffer>& buffer : threadBuffers)
+					buffers.Add(buffer.Get());
+			}
+
+			const double	microsecondsPerCycle = FPlatformTime::GetSecondsPerCycle64() * 1000000.0;
+			const uint32	processId = FPlatformProcess::GetCurrentProcessId();
+			int32			eventCount = 0;
+
+			FString json = TEXT("{\"traceEvents\":[\n");
+			for (FThreadBuffer* buffer : buffers)
+			{
+				const FString threadName = FThreadManager::GetThreadName(buffer->m_ThreadId);
+				json += FString::Printf(TEXT("{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%u,\"tid\":%u,\"args\":{\"name\":\"%s\"}},\n"),
+					processId, buffer->m_ThreadId, *EscapeJson(threadName.IsEmpty() ? *FString::Printf(TEXT("Thread %u"), buffer->m_ThreadId) : *threadName));
+
+				const int32 writeCount = buffer->m_WriteCount.GetValue();
+				const int32 firstEvent = FMath::Max(0, writeCount - EventsPerThread);
+				for (int32 iEvent = firstEvent; iEvent < writeCount; ++iEvent)
+				{
+					FTraceEvent& slot = buffer->m_Events[iEvent % EventsPerThread];
+
+					// Copy the event and discard it if the owning thread overwrote it meanwhile
+					const int32 sequence = slot.m_Sequence.GetValue();
+					if (sequence & 1)
+						continue;
+					FTraceEvent event;
+					event.m_Name = slot.m_Name;
+					FMemory::Memcpy(event.m_Detail, slot.m_Detail, sizeof(event.m_Detail));
+					event.m_StartCycles = slot.m_StartCycles;
+					event.m_EndCycles = slot.m_EndCycles;
+					FPlatformMisc::MemoryBarrier();
+					if (slot.m_Sequence.GetValue() != sequence)
+						continue;
+
+					json += FString::Printf(TEXT("{\"name\":\"%s\",\"cat\":\"RPR\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%u,\"tid\":%u"),
+						*EscapeJson(event.m_Name), event.m_StartCycles * microsecondsPerCycle, (event.m_EndCycles - event.m_StartCycles) * microsecondsPerCycle,
+						processId, buffer->m_ThreadId);
+					if (event.m_Detail[0] != 0)
+						json += FString::Printf(TEXT(",\"args\":{\"detail\":\"%s\"}"), *EscapeJson(event.m_Detail));
+					json += TEXT("},\n");
+					++eventCount;
+				}
+			}
+			json.RemoveFromEnd(TEXT(",\n"));
+			json += TEXT("\n],\"displayTimeUnit\":\"ms\"}\n");
+
+			if (!FFileHelper::SaveStringToFile(json, *Filename))
+			{
+				UE_LOG(LogRPRTrace, Error, TEXT("Couldn't write ProRender trace to '%s'"), *Filename);
+				return (false);
+			}
+
+			UE_LOG(LogRPRTrace, Log, TEXT("%d events from %d threads written to '%s'"), eventCount, buffers.Num(), *Filename);
+			return (true);
+		}
+
+		FScopedEvent::FScopedEvent(const TCHAR* name, const TCHAR* detail)
+			: m_Name(name)
+			, m_StartCycles(0)
+		{
+			if (traceEnabled)
+			{
+				if (detail != nullptr)
+					FCString::Strncpy(m_Detail, detail, DetailLength);
+				else
+					m_Detail[0] = 0;
+				m_StartCycles = FPlatformTime::Cycles64();
+			}
+		}
+
+		FScopedEvent::~FScopedEvent()
+		{
+			if (m_StartCycles == 0)
+				return;
+
+			const uint64	endCycles = FPlatformTime::Cycles64();
+			FThreadBuffer&	buffer = GetThreadBuffer();
+			FTraceEvent&	slot = buffer.m_Events[buffer.m_WriteCount.GetValue() % EventsPerThread];
+
+			slot.m_Sequence.Increment();
+			slot.m_Name = m_Name;
+			FMemory::Memcpy(slot.m_Detail, m_Detail, sizeof(m_Detail));
+			slot.m_StartCycles = m_StartCycles;
+			slot.m_EndCycles = endCycles;
+			slot.m_Sequence.Increment();
+			buffer.m_WriteCount.Increment();
+		}
+
+	}
+}
@@ -33,6 +33,8 @@ URPRSettings::URPRSettings(const FObjectInitializer& PCIP)
 	, bEnableGPU7(true)
 	, bEnableGPU8(true)
 	, bEnableCPU(false) // By default, no GPUs available, abort
+	, bBalanceDeviceWorkload(true)
+	, TargetRenderCallTime(0.05f)
 	, QualitySettings(ERPRQualitySettings::Full)
 	, DenoiserOption(ERPRDenoiserOption::ML)
 	, MegaPixelCount(2.0f)
@@ -58,6 +60,9 @@ URPRSettings::URPRSettings(const FObjectInitializer& PCIP)
 	, RadianceClamp(1.0f)
 	, UseDenoiser(false)
 	, bUseErrorTexture(true)
+	, MaxTextureResolution(0)
+	, TextureMemoryBudget(0)
+	, EnvironmentMapWidth(0)
 	, IsHybrid(false)
 	, CurrentRenderType(ERenderType::None)
 	, EnableAdaptiveSampling(false)
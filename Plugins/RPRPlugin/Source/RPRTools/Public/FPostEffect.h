@@ -17,6 +17,7 @@
 #pragma once
 
 #include <RadeonProRender.h>
+#include "Containers/Map.h"
 
 #ifdef RPRTOOLS_API
 #define POSTEFFECT_DLL_API __declspec( dllexport )
@@ -39,6 +40,8 @@ public:
 	int Attach(rpr_context context);
 	int Detach(rpr_context context);
 
+	// Setting the value a parameter already has doesn't reach RPR.
+	// Keys are string literals and are told apart by address, so the per frame sets don't allocate
 	int SetFloat(const char* key, float value);
 	int SetUInt(const char* key, unsigned int value);
 
@@ -47,7 +50,11 @@ public:
 	FPostEffect(const FPostEffect&)            = delete;
 	FPostEffect& operator=(const FPostEffect&) = delete;
 private:
+	bool IsParameterUnchanged(const char* key, unsigned int bits) const;
+
 	rpr_post_effect	PostEffect;
+	// Last value set per parameter, floats by their bits
+	TMap<const char*, unsigned int> Parameters;
 };
 
 inline int ContextCreatePostEffect(rpr_context context, rpr_post_effect_type type, FPostEffect* out_post_effect)
@@ -49,14 +49,22 @@ namespace RPR
 		RPRTOOLS_API FResult        UnSetAOV(FContext Context, RPR::EAOV AOV);
 		RPRTOOLS_API FResult        GetInfo(FContext context, rpr_int param, size_t outBufferSize, void* outBuffer, size_t* returnedDataSize = nullptr);
 		RPRTOOLS_API FResult		Render(FContext Context);
+		RPRTOOLS_API FResult		RenderTile(FContext Context, uint32 MinX, uint32 MaxX, uint32 MinY, uint32 MaxY);
 		RPRTOOLS_API FResult		ResolveFrameBuffer(FContext Context, FFrameBuffer& SrcFrameBuffer, FFrameBuffer& DstFrameBuffer, bool bNormalizeOnly = false);
 
 		RPRTOOLS_API FResult		CreateInstance(FContext Context, RPR::FShape Shape, RPR::FShape& OutShapeInstance);
 		RPRTOOLS_API FResult		CreateInstance(FContext Context, RPR::FShape Shape, const FString& InstanceName, RPR::FShape& OutShapeInstance);
 
 		RPRTOOLS_API FResult		CreateMesh(FContext Context, const TCHAR* MeshName,
-										const TArray<FVector>& Vertices, const TArray<FVector>& Normals, const TArray<uint32>& Indices,
-										const TArray<FVector2D>& Texcoords, const TArray<uint32>& NumFaceVertices, FShape& OutMesh);
+										TArrayView<const FVector> Vertices, TArrayView<const FVector> Normals, TArrayView<const uint32> Indices,
+										TArrayView<const FVector2D> Texcoords, TArrayView<const uint32> NumFaceVertices, FShape& OutMesh);
+
+		/* Each attribute has its own index stream, so positions, normals and texcoords can be welded independently */
+		RPRTOOLS_API FResult		CreateMesh(FContext Context, const TCHAR* MeshName,
+										TArrayView<const FVector> Vertices, TArrayView<const uint32> VertexIndices,
+										TArrayView<const FVector> Normals, TArrayView<const uint32> NormalIndices,
+										TArrayView<const FVector2D> Texcoords, TArrayView<const uint32> TexcoordIndices,
+										TArrayView<const uint32> NumFaceVertices, FShape& OutMesh);
 
 		namespace MaterialSystem
 		{
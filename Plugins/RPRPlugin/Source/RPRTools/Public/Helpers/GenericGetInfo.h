@@ -51,8 +51,9 @@ namespace RPR
 			return (status);
 		}
 
-		template<typename T, typename U>
-		RPR::FResult GetInfoToArray(FGetInfoFunction GetInfoFunction, void* Source, U InfoType, TArray<T>& OutValue)
+		// OutValue keeps its allocation, so a buffer reused across calls only grows
+		template<typename T, typename U, typename TAllocator>
+		RPR::FResult GetInfoToArray(FGetInfoFunction GetInfoFunction, void* Source, U InfoType, TArray<T, TAllocator>& OutValue)
 		{
 			RPR::FResult status;
 			size_t size;
@@ -64,17 +65,30 @@ namespace RPR
 				return (status);
 			}
 
-			uint64 numElements = size / sizeof(T);
-			if (OutValue.Num() > numElements)
+			OutValue.SetNumUninitialized(size / sizeof(T), false);
+			status = GetInfoFunction(Source, (rpr_int) InfoType, size, OutValue.GetData(), nullptr);
+			if (RPR::IsResultFailed(status))
 			{
-				OutValue.Empty(numElements);
+				UE_LOG(LogRPRGetInfo, Error, TEXT("Cannot get info (source : %p, type : %d) -> %d"), Source, (uint32) InfoType, status);
 			}
 
-			OutValue.AddUninitialized(numElements - OutValue.Num());
-			status = GetInfoFunction(Source, (rpr_int) InfoType, size, OutValue.GetData(), nullptr);
+			return (status);
+		}
+
+		// Single query when the number of elements is already known (vertex count, image description...)
+		template<typename T, typename U, typename TAllocator>
+		RPR::FResult GetInfoToArray(FGetInfoFunction GetInfoFunction, void* Source, U InfoType, int32 NumElements, TArray<T, TAllocator>& OutValue)
+		{
+			OutValue.SetNumUninitialized(NumElements, false);
+			if (NumElements == 0)
+			{
+				return RPR_SUCCESS;
+			}
+
+			RPR::FResult status = GetInfoFunction(Source, (rpr_int) InfoType, NumElements * sizeof(T), OutValue.GetData(), nullptr);
 			if (RPR::IsResultFailed(status))
 			{
-				UE_LOG(LogRPRGetInfo, Error, TEXT("Cannot get info (source : %p, type : %d) -> %d"), Source, (uint32) InfoType, status);
+				UE_LOG(LogRPRGetInfo, Error, TEXT("Cannot get info (source : %p, type : %d, count : %d) -> %d"), Source, (uint32) InfoType, NumElements, status);
 			}
 
 			return (status);
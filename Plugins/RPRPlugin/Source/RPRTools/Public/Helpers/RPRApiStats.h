@@ -0,0 +1,320 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <RadeonProRender.h>
+
+/*
+* Call counts, cumulative time and bytes handed to the RPR entry points the plugin uses the most.
+*
+* When RPR_API_STATS is set (everything but shipping, see RPRTools.Build.cs), including this header after
+* RadeonProRender.h redirects those entry points to inline wrappers that record each call.
+* Otherwise the calls go straight to RPR and nothing is recorded.
+* Use the console commands RPR.Api.Dump [calls|time|bytes|name] and RPR.Api.Reset.
+*/
+
+#ifndef RPR_API_STATS
+#define RPR_API_STATS 0
+#endif
+
+#define RPR_API_STATS_FUNCTIONS(Op) \
+	Op(ContextCreateMesh) \
+	Op(ContextCreateInstance) \
+	Op(ContextCreateImage) \
+	Op(ContextCreateFrameBuffer) \
+	Op(ContextSetParameterByKey1u) \
+	Op(ContextSetParameterByKey1f) \
+	Op(ContextRender) \
+	Op(ContextRenderTile) \
+	Op(ContextResolveFrameBuffer) \
+	Op(FrameBufferGetInfo) \
+	Op(ImageGetInfo) \
+	Op(MaterialSystemCreateNode) \
+	Op(MaterialNodeSetInputFByKey) \
+	Op(MaterialNodeSetInputUByKey) \
+	Op(MaterialNodeSetInputNByKey) \
+	Op(MaterialNodeSetInputImageDataByKey) \
+	Op(ShapeSetTransform) \
+	Op(ShapeSetMaterial) \
+	Op(LightSetTransform) \
+	Op(SceneAttachShape) \
+	Op(SceneDetachShape) \
+	Op(SceneAttachLight) \
+	Op(SceneDetachLight) \
+	Op(ObjectDelete)
+
+namespace RPR
+{
+	namespace ApiStats
+	{
+		// Named after the entry points, without their "rpr" prefix
+		enum class EFunction : uint8
+		{
+#define RPR_API_STATS_ENUM(Name) Name,
+			RPR_API_STATS_FUNCTIONS(RPR_API_STATS_ENUM)
+#undef RPR_API_STATS_ENUM
+			Count
+		};
+
+		struct FFunctionStats
+		{
+			const TCHAR*	Name;
+			int64			Calls;
+			double			Seconds;
+			int64			Bytes;
+		};
+
+		// Lock free, called from any thread
+		RPRTOOLS_API void	Record(EFunction Function, uint64 Cycles, int64 ByteCount);
+
+		RPRTOOLS_API void	Reset();
+
+		/* Functions called since the last reset, in declaration order */
+		RPRTOOLS_API void	GetStats(TArray<FFunctionStats>& OutStats);
+
+		/* Sorted by "time", "calls", "bytes" or "name" */
+		RPRTOOLS_API void	Dump(const FString& SortMode);
+
+		class FScopedCall
+		{
+		public:
+
+			FORCEINLINE FScopedCall(EFunction InFunction, int64 InByteCount)
+				: Function(InFunction)
+				, ByteCount(InByteCount)
+				, StartCycles(FPlatformTime::Cycles64())
+			{}
+
+			FORCEINLINE ~FScopedCall()
+			{
+				Record(Function, FPlatformTime::Cycles64() - StartCycles, ByteCount);
+			}
+
+		private:
+
+			EFunction	Function;
+			int64		ByteCount;
+			uint64		StartCycles;
+		};
+	}
+}
+
+#if RPR_API_STATS
+
+#define RPR_API_STATS_SCOPE(Function, ByteCount) \
+	RPR::ApiStats::FScopedCall ANONYMOUS_VARIABLE(RPRApiCall_)(RPR::ApiStats::EFunction::Function, ByteCount)
+
+inline rpr_status RPRApiStats_rprContextCreateMesh(rpr_context context,
+	rpr_float const* vertices, size_t num_vertices, rpr_int vertex_stride,
+	rpr_float const* normals, size_t num_normals, rpr_int normal_stride,
+	rpr_float const* texcoords, size_t num_texcoords, rpr_int texcoord_stride,
+	rpr_int const* vertex_indices, rpr_int vidx_stride,
+	rpr_int const* normal_indices, rpr_int nidx_stride,
+	rpr_int const* texcoord_indices, rpr_int tidx_stride,
+	rpr_int const* num_face_vertices, size_t num_faces,
+	rpr_shape* out_mesh)
+{
+	// Estimated for triangles, which is what the plugin sends, rather than walking num_face_vertices on every mesh
+	const int64	indexCount = int64(num_faces) * 3;
+	const int64	byteCount =
+		int64(num_vertices) * vertex_stride + int64(num_normals) * normal_stride + int64(num_texcoords) * texcoord_stride +
+		indexCount * (vidx_stride + (normal_indices != nullptr ? nidx_stride : 0) + (texcoord_indices != nullptr ? tidx_stride : 0)) +
+		int64(num_faces) * sizeof(rpr_int);
+
+	RPR_API_STATS_SCOPE(ContextCreateMesh, byteCount);
+	return rprContextCreateMesh(context,
+		vertices, num_vertices, vertex_stride,
+		normals, num_normals, normal_stride,
+		texcoords, num_texcoords, texcoord_stride,
+		vertex_indices, vidx_stride,
+		normal_indices, nidx_stride,
+		texcoord_indices, tidx_stride,
+		num_face_vertices, num_faces,
+		out_mesh);
+}
+#define rprContextCreateMesh RPRApiStats_rprContextCreateMesh
+
+inline rpr_status RPRApiStats_rprContextCreateInstance(rpr_context context, rpr_shape shape, rpr_shape* out_instance)
+{
+	RPR_API_STATS_SCOPE(ContextCreateInstance, 0);
+	return rprContextCreateInstance(context, shape, out_instance);
+}
+#define rprContextCreateInstance RPRApiStats_rprContextCreateInstance
+
+inline rpr_status RPRApiStats_rprContextCreateImage(rpr_context context, rpr_image_format const format, rpr_image_desc const* image_desc, void const* data, rpr_image* out_image)
+{
+	const int64	byteCount = image_desc != nullptr ?
+		int64(image_desc->image_row_pitch) * image_desc->image_height * FMath::Max<int64>(image_desc->image_depth, 1) : 0;
+
+	RPR_API_STATS_SCOPE(ContextCreateImage, byteCount);
+	return rprContextCreateImage(context, format, image_desc, data, out_image);
+}
+#define rprContextCreateImage RPRApiStats_rprContextCreateImage
+
+inline rpr_status RPRApiStats_rprContextCreateFrameBuffer(rpr_context context, rpr_framebuffer_format const format, rpr_framebuffer_desc const* fb_desc, rpr_framebuffer* out_fb)
+{
+	// Allocated by RPR, nothing is transferred
+	RPR_API_STATS_SCOPE(ContextCreateFrameBuffer, 0);
+	return rprContextCreateFrameBuffer(context, format, fb_desc, out_fb);
+}
+#define rprContextCreateFrameBuffer RPRApiStats_rprContextCreateFrameBuffer
+
+inline rpr_status RPRApiStats_rprContextSetParameterByKey1u(rpr_context context, rpr_context_info in_input, rpr_uint x)
+{
+	RPR_API_STATS_SCOPE(ContextSetParameterByKey1u, sizeof(x));
+	return rprContextSetParameterByKey1u(context, in_input, x);
+}
+#define rprContextSetParameterByKey1u RPRApiStats_rprContextSetParameterByKey1u
+
+inline rpr_status RPRApiStats_rprContextSetParameterByKey1f(rpr_context context, rpr_context_info in_input, rpr_float x)
+{
+	RPR_API_STATS_SCOPE(ContextSetParameterByKey1f, sizeof(x));
+	return rprContextSetParameterByKey1f(context, in_input, x);
+}
+#define rprContextSetParameterByKey1f RPRApiStats_rprContextSetParameterByKey1f
+
+inline rpr_status RPRApiStats_rprContextRender(rpr_context context)
+{
+	RPR_API_STATS_SCOPE(ContextRender, 0);
+	return rprContextRender(context);
+}
+#define rprContextRender RPRApiStats_rprContextRender
+
+inline rpr_status RPRApiStats_rprContextRenderTile(rpr_context context, rpr_uint xmin, rpr_uint xmax, rpr_uint ymin, rpr_uint ymax)
+{
+	RPR_API_STATS_SCOPE(ContextRenderTile, 0);
+	return rprContextRenderTile(context, xmin, xmax, ymin, ymax);
+}
+#define rprContextRenderTile RPRApiStats_rprContextRenderTile
+
+inline rpr_status RPRApiStats_rprContextResolveFrameBuffer(rpr_context context, rpr_framebuffer src_frame_buffer, rpr_framebuffer dst_frame_buffer, rpr_bool noDisplayGamma)
+{
+	RPR_API_STATS_SCOPE(ContextResolveFrameBuffer, 0);
+	return rprContextResolveFrameBuffer(context, src_frame_buffer, dst_frame_buffer, noDisplayGamma);
+}
+#define rprContextResolveFrameBuffer RPRApiStats_rprContextResolveFrameBuffer
+
+inline rpr_status RPRApiStats_rprFrameBufferGetInfo(rpr_framebuffer framebuffer, rpr_framebuffer_info info, size_t size, void* data, size_t* size_ret)
+{
+	// Size queries pass no data, only the read backs count
+	RPR_API_STATS_SCOPE(FrameBufferGetInfo, data != nullptr ? int64(size) : 0);
+	return rprFrameBufferGetInfo(framebuffer, info, size, data, size_ret);
+}
+#define rprFrameBufferGetInfo RPRApiStats_rprFrameBufferGetInfo
+
+inline rpr_status RPRApiStats_rprImageGetInfo(rpr_image image, rpr_image_info image_info, size_t size, void* data, size_t* size_ret)
+{
+	RPR_API_STATS_SCOPE(ImageGetInfo, data != nullptr ? int64(size) : 0);
+	return rprImageGetInfo(image, image_info, size, data, size_ret);
+}
+#define rprImageGetInfo RPRApiStats_rprImageGetInfo
+
+inline rpr_status RPRApiStats_rprMaterialSystemCreateNode(rpr_material_system in_matsys, rpr_material_node_type in_type, rpr_material_node* out_node)
+{
+	RPR_API_STATS_SCOPE(MaterialSystemCreateNode, 0);
+	return rprMaterialSystemCreateNode(in_matsys, in_type, out_node);
+}
+#define rprMaterialSystemCreateNode RPRApiStats_rprMaterialSystemCreateNode
+
+inline rpr_status RPRApiStats_rprMaterialNodeSetInputFByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_float in_value_x, rpr_float in_value_y, rpr_float in_value_z, rpr_float in_value_w)
+{
+	RPR_API_STATS_SCOPE(MaterialNodeSetInputFByKey, 4 * sizeof(rpr_float));
+	return rprMaterialNodeSetInputFByKey(in_node, in_input, in_value_x, in_value_y, in_value_z, in_value_w);
+}
+#define rprMaterialNodeSetInputFByKey RPRApiStats_rprMaterialNodeSetInputFByKey
+
+inline rpr_status RPRApiStats_rprMaterialNodeSetInputUByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_uint in_value)
+{
+	RPR_API_STATS_SCOPE(MaterialNodeSetInputUByKey, sizeof(in_value));
+	return rprMaterialNodeSetInputUByKey(in_node, in_input, in_value);
+}
+#define rprMaterialNodeSetInputUByKey RPRApiStats_rprMaterialNodeSetInputUByKey
+
+inline rpr_status RPRApiStats_rprMaterialNodeSetInputNByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_material_node in_input_node)
+{
+	RPR_API_STATS_SCOPE(MaterialNodeSetInputNByKey, 0);
+	return rprMaterialNodeSetInputNByKey(in_node, in_input, in_input_node);
+}
+#define rprMaterialNodeSetInputNByKey RPRApiStats_rprMaterialNodeSetInputNByKey
+
+inline rpr_status RPRApiStats_rprMaterialNodeSetInputImageDataByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_image image)
+{
+	RPR_API_STATS_SCOPE(MaterialNodeSetInputImageDataByKey, 0);
+	return rprMaterialNodeSetInputImageDataByKey(in_node, in_input, image);
+}
+#define rprMaterialNodeSetInputImageDataByKey RPRApiStats_rprMaterialNodeSetInputImageDataByKey
+
+inline rpr_status RPRApiStats_rprShapeSetTransform(rpr_shape shape, rpr_bool transpose, rpr_float const* transform)
+{
+	RPR_API_STATS_SCOPE(ShapeSetTransform, 16 * sizeof(rpr_float));
+	return rprShapeSetTransform(shape, transpose, transform);
+}
+#define rprShapeSetTransform RPRApiStats_rprShapeSetTransform
+
+inline rpr_status RPRApiStats_rprShapeSetMaterial(rpr_shape shape, rpr_material_node node)
+{
+	RPR_API_STATS_SCOPE(ShapeSetMaterial, 0);
+	return rprShapeSetMaterial(shape, node);
+}
+#define rprShapeSetMaterial RPRApiStats_rprShapeSetMaterial
+
+inline rpr_status RPRApiStats_rprLightSetTransform(rpr_light light, rpr_bool transpose, rpr_float const* transform)
+{
+	RPR_API_STATS_SCOPE(LightSetTransform, 16 * sizeof(rpr_float));
+	return rprLightSetTransform(light, transpose, transform);
+}
+#define rprLightSetTransform RPRApiStats_rprLightSetTransform
+
+inline rpr_status RPRApiStats_rprSceneAttachShape(rpr_scene scene, rpr_shape shape)
+{
+	RPR_API_STATS_SCOPE(SceneAttachShape, 0);
+	return rprSceneAttachShape(scene, shape);
+}
+#define rprSceneAttachShape RPRApiStats_rprSceneAttachShape
+
+inline rpr_status RPRApiStats_rprSceneDetachShape(rpr_scene scene, rpr_shape shape)
+{
+	RPR_API_STATS_SCOPE(SceneDetachShape, 0);
+	return rprSceneDetachShape(scene, shape);
+}
+#define rprSceneDetachShape RPRApiStats_rprSceneDetachShape
+
+inline rpr_status RPRApiStats_rprSceneAttachLight(rpr_scene scene, rpr_light light)
+{
+	RPR_API_STATS_SCOPE(SceneAttachLight, 0);
+	return rprSceneAttachLight(scene, light);
+}
+#define rprSceneAttachLight RPRApiStats_rprSceneAttachLight
+
+inline rpr_status RPRApiStats_rprSceneDetachLight(rpr_scene scene, rpr_light light)
+{
+	RPR_API_STATS_SCOPE(SceneDetachLight, 0);
+	return rprSceneDetachLight(scene, light);
+}
+#define rprSceneDetachLight RPRApiStats_rprSceneDetachLight
+
+inline rpr_status RPRApiStats_rprObjectDelete(void* obj)
+{
+	RPR_API_STATS_SCOPE(ObjectDelete, 0);
+	return rprObjectDelete(obj);
+}
+#define rprObjectDelete RPRApiStats_rprObjectDelete
+
+#undef RPR_API_STATS_SCOPE
+
+#endif // RPR_API_STATS
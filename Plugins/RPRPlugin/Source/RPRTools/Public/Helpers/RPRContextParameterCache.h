@@ -0,0 +1,61 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RPRToolsModule.h"
+#include "Typedefs/RPRTypedefs.h"
+
+namespace RPR
+{
+	/*
+	* Remembers the last value set on each context parameter, so setting the same value again doesn't reach RPR.
+	* Some backends dirty the scene on any parameter set, which restarts the accumulation for nothing.
+	* Only knows about the values set through it, RPR thread only.
+	*/
+	class RPRTOOLS_API FContextParameterCache
+	{
+	public:
+
+		enum class EChange : uint8
+		{
+			// Same value as the last one set, nothing was sent
+			None,
+			// Only changes how the accumulated samples are resolved (tonemapping, gamma)
+			Display,
+			// The accumulated samples are no longer valid, the render has to restart
+			Restart
+		};
+
+		FResult	Set1u(FContext Context, rpr_context_info Parameter, uint32 Value, EChange* OutChange = nullptr);
+		FResult	Set1f(FContext Context, rpr_context_info Parameter, float Value, EChange* OutChange = nullptr);
+
+		/* Forgets every value, the next sets reach RPR again. Needed when the context is recreated */
+		void	Reset();
+
+		static bool	RequiresRestart(rpr_context_info Parameter);
+
+	private:
+
+		bool	IsUnchanged(rpr_context_info Parameter, uint32 Bits) const;
+
+	private:
+
+		// Float values are stored by their bits
+		TMap<rpr_context_info, uint32>	values;
+	};
+}
@@ -28,6 +28,12 @@
 RPRTOOLS_API RadeonProRender::matrix BuildMatrixNoScale(const struct FTransform &transform, float translationScale = 1.0f);
 RPRTOOLS_API RadeonProRender::matrix BuildMatrixWithScale(const struct FTransform &transform, float translationScale = 1.0f);
 
+/*
+* Same conversion as BuildMatrixWithScale for a whole array, vectorized and split across worker threads for large batches.
+* OutMatrices must have as many elements as Transforms.
+*/
+RPRTOOLS_API void BuildMatricesWithScale(TArrayView<const struct FTransform> Transforms, TArrayView<RadeonProRender::matrix> OutMatrices, float translationScale = 1.0f);
+
 namespace RPR
 {
 	/*
@@ -0,0 +1,53 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "RPRToolsModule.h"
+#include "Typedefs/RPRTypedefs.h"
+
+namespace RPR
+{
+	/*
+	* Bookkeeping of the RPR objects that own device memory, used to tell which assets fill up the GPU.
+	* Byte counts are estimates of the data handed to RPR, the SDK does not report its own allocations.
+	* Dumped with "RPR.Memory.Dump [size|name|category] [Count]" and visible in "stat ProRenderMemory".
+	*/
+	namespace Memory
+	{
+		enum class ECategory : uint8
+		{
+			Mesh,
+			Instance,
+			Image,
+			FrameBuffer,
+			Denoiser,
+			Count
+		};
+
+		/* Records an object, tracking an already tracked object replaces its entry */
+		RPRTOOLS_API void		Track(const void* Object, ECategory Category, int64 ByteCount, const FString& Source);
+
+		/* Forgets an object, unknown objects are ignored so every delete site can call it */
+		RPRTOOLS_API void		Untrack(const void* Object);
+
+		RPRTOOLS_API int64		GetTotal(ECategory Category);
+
+		/* Logs the failing asset and the current totals when Status is an out of memory error */
+		RPRTOOLS_API void		LogOutOfMemory(FResult Status, const FString& Source);
+	}
+}
@@ -24,21 +24,49 @@ namespace RPR
 {
 	namespace Mesh
 	{
+		struct FCounts
+		{
+			uint32	Vertices;
+			uint32	Normals;
+			uint32	UVs;
+			uint32	VertexIndices;
+			uint32	NormalIndices;	// 0 without normals
+			uint32	UVIndices;		// 0 without UVs
+			uint32	Faces;
+		};
+
+		/*
+		* Counts of the meshes created through RPR::Context::CreateMesh, forgotten by RPR::DeleteObject.
+		* Lets readers size their arrays without asking RPR. Meshes created elsewhere aren't found.
+		*/
+		RPRTOOLS_API void			RecordCounts(RPR::FShape Mesh, const FCounts& Counts);
+		RPRTOOLS_API void			ForgetCounts(const void* Object);
+		RPRTOOLS_API bool			FindCounts(RPR::FShape Mesh, FCounts& OutCounts);
+
 		RPRTOOLS_API RPR::FResult GetVertices(RPR::FShape Shape, TArray<FVector>& OutVertices);
+		// Skip the size query when the count is already known. The arrays keep their allocation, reuse them across meshes
+		RPRTOOLS_API RPR::FResult GetVertices(RPR::FShape Shape, uint32 VerticesCount, TArray<FVector>& OutVertices);
 		RPRTOOLS_API RPR::FResult GetVerticesCount(RPR::FShape Shape, uint32& OutVerticesCount);
 		RPRTOOLS_API RPR::FResult GetVertexIndexes(RPR::FShape Shape, TArray<uint32>& OutVerticesIndexes);
+		RPRTOOLS_API RPR::FResult GetVertexIndexes(RPR::FShape Shape, uint32 IndicesCount, TArray<uint32>& OutVerticesIndexes);
 		RPRTOOLS_API RPR::FResult GetVerticesIndexesStride(RPR::FShape Shape, uint32& OutStride);
 
 		RPRTOOLS_API RPR::FResult GetNormals(RPR::FShape Shape, TArray<FVector>& OutNormals);
+		RPRTOOLS_API RPR::FResult GetNormals(RPR::FShape Shape, uint32 NormalsCount, TArray<FVector>& OutNormals);
 		RPRTOOLS_API RPR::FResult GetNormalsCount(RPR::FShape Shape, uint32& OutNormalsCount);
 		RPRTOOLS_API RPR::FResult GetNormalsIndexes(RPR::FShape Shape, TArray<uint32>& OutNormalsIndexes);
+		RPRTOOLS_API RPR::FResult GetNormalsIndexes(RPR::FShape Shape, uint32 IndicesCount, TArray<uint32>& OutNormalsIndexes);
 		RPRTOOLS_API RPR::FResult GetNormalsIndexesStride(RPR::FShape Shape, uint32& OutStride);
 		
 		RPRTOOLS_API RPR::FResult GetUV(RPR::FShape Shape, uint32 UVChannel, TArray<FVector2D>& OutUVs);
+		RPRTOOLS_API RPR::FResult GetUV(RPR::FShape Shape, uint32 UVChannel, uint32 UVsCount, TArray<FVector2D>& OutUVs);
 		RPRTOOLS_API RPR::FResult GetUVCount(RPR::FShape Shape, uint32 UVChannel, uint32& OutUVsCount);
 		RPRTOOLS_API RPR::FResult GetNumUV(RPR::FShape Shape, uint32& OutNumUVChannels);
+		RPRTOOLS_API RPR::FResult GetUVsIndexes(RPR::FShape Shape, TArray<uint32>& OutUVsIndexes);
+		RPRTOOLS_API RPR::FResult GetUVsIndexes(RPR::FShape Shape, uint32 IndicesCount, TArray<uint32>& OutUVsIndexes);
 		RPRTOOLS_API RPR::FResult GetUVsIndexesStride(RPR::FShape Shape, uint32& OutStride);
 
 		RPRTOOLS_API RPR::FResult GetNumFaceVertices(RPR::FShape, TArray<uint32>& OutNumFaceVertices);
+		RPRTOOLS_API RPR::FResult GetNumFaceVertices(RPR::FShape, uint32 FacesCount, TArray<uint32>& OutNumFaceVertices);
 	}
 }
@@ -24,14 +24,23 @@ namespace RPR
 	{
 	private:
 
-		// Data struct to cache mesh data from mesh instance and re-use it for every instance
+		// CPU copy of a mesh, reused from one mesh to the next while the meshes are standardized
 		struct FMeshData
 		{
 			TArray<FVector> Vertices;
 			TArray<FVector> Normals;
 			TArray<uint32> Indices;
+			TArray<uint32> NormalIndices;
 			TArray<FVector2D> TexCoords;
+			TArray<uint32> TexCoordIndices;
 			TArray<uint32> NumFacesVertices;
+		};
+
+		struct FInstanceData
+		{
+			FShape Instance;
+			FShape MeshShape;
+			FTransform Transform;
 			RPR::FMaterialNode Material;
 		};
 
@@ -43,10 +52,11 @@ namespace RPR
 
 	private:
 
-		// Copy shapes and transform shape instances into shape meshes
+		// Copy shape instances, each source mesh is re-created once and shared by all its instances
 		static void StandardizeShapes(RPR::FContext Context, RPR::FScene SrcScene, RPR::FScene DstScene);
 
-		static FMeshData* FindOrCacheMeshShape(TMap<FShape, FMeshData>& MeshDataCache, FShape ShapeInstance, FShape MeshShape);
+		// Creates the rescaled copy of a mesh, hidden and attached to the scene like the UE4 scene base meshes
+		static FShape CreateStandardizedMesh(RPR::FContext Context, RPR::FScene DstScene, FShape MeshShape, FMeshData& MeshData);
 
 		static void CopyAllLights(RPR::FContext Context, RPR::FScene SrcScene, RPR::FScene DstScene);
 
@@ -0,0 +1,44 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Misc/MemStack.h"
+
+namespace RPR
+{
+	/*
+	* Temporaries of the scene build (mesh sections, texture conversions) are allocated on the calling
+	* thread's FMemStack instead of the heap. They are released by the innermost FMemMark, the RPR thread
+	* pops everything left after each BuildQueuedObjects batch.
+	*/
+	namespace ScratchMemory
+	{
+		template<typename T>
+		using TScratchArray = TArray<T, TMemStackAllocator<>>;
+
+		template<typename TKey, typename TValue>
+		using TScratchMap = TMap<TKey, TValue, TSetAllocator<TSparseArrayAllocator<TMemStackAllocator<>, TMemStackAllocator<>>, TMemStackAllocator<>>>;
+
+		/* Samples the current thread's scratch usage, call once the temporaries of a step are allocated */
+		RPRTOOLS_API void		TrackUsage();
+
+		/* Highest sampled usage since the last reset, in bytes */
+		RPRTOOLS_API int64		GetHighWaterMark();
+		RPRTOOLS_API void		ResetHighWaterMark();
+	}
+}
@@ -0,0 +1,61 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* Timeline of the plugin's pipeline stages, exported in the Chrome trace_event format
+* (open the file in chrome://tracing or https://ui.perfetto.dev).
+*
+* Events are recorded into a fixed-size ring buffer owned by each thread, so recording never takes a lock.
+* Use the console commands RPR.Trace.Start, RPR.Trace.Stop and RPR.Trace.Dump [Filename].
+*/
+namespace RPR
+{
+	namespace Trace
+	{
+		RPRTOOLS_API void	SetEnabled(bool bEnabled);
+		RPRTOOLS_API bool	IsEnabled();
+
+		// Write the recorded events to Filename. Recording can continue while dumping.
+		RPRTOOLS_API bool	Dump(const FString& Filename);
+
+		class RPRTOOLS_API FScopedEvent
+		{
+		public:
+			static const int32	DetailLength = 64;
+
+			// name must be a static string. detail is copied (and truncated) when tracing is enabled.
+			FScopedEvent(const TCHAR* name, const TCHAR* detail = nullptr);
+			~FScopedEvent();
+
+		private:
+			const TCHAR*	m_Name;
+			TCHAR			m_Detail[DetailLength];
+			uint64			m_StartCycles;
+		};
+	}
+}
+
+#define RPR_TRACE_SCOPE(Name) \
+	RPR::Trace::FScopedEvent ANONYMOUS_VARIABLE(RPRTraceScope_)(TEXT(Name))
+
+// Detail is only evaluated when tracing is enabled
+#define RPR_TRACE_SCOPE_DETAIL(Name, Detail) \
+	RPR::Trace::FScopedEvent ANONYMOUS_VARIABLE(RPRTraceScope_)(TEXT(Name), RPR::Trace::IsEnabled() ? (const TCHAR*) (Detail) : nullptr)
@@ -101,6 +101,14 @@ public:
 	UPROPERTY(Config, EditAnywhere, Category = Devices, meta = (ConfigRestartRequired = true))
 	uint32		bEnableCPU : 1;
 
+	/** Batches several iterations per render call, sized from the measured throughput, so every enabled device gets a share of each call (Tahoe only) */
+	UPROPERTY(Config, EditAnywhere, Category = Devices)
+	uint32		bBalanceDeviceWorkload : 1;
+
+	/** Time budget of a single batched render call, in seconds. Lower keeps the viewport responsive, higher reduces per call overhead */
+	UPROPERTY(Config, EditAnywhere, Category = Devices, meta = (EditCondition = "bBalanceDeviceWorkload", ClampMin = "0.01", ClampMax = "1.0"))
+	float		TargetRenderCallTime;
+
 	UPROPERTY(Config)
 	TEnumAsByte<ERPRQualitySettings>		QualitySettings;
 
@@ -194,6 +202,15 @@ public:
 	UPROPERTY(Config, EditAnywhere, meta = (Tooltip = "The texture to use when the RPR plugin cannot load the texture correctly."), Category = ImageManager)
 	TSoftObjectPtr<UTexture2D>	ErrorTexture;
 
+	UPROPERTY(Config, EditAnywhere, meta = (Tooltip = "Largest side, in pixels, of the textures sent to RPR. Bigger textures are loaded from a lower mip. 0 doesn't limit.", ClampMin = 0), Category = ImageManager)
+	int32			MaxTextureResolution;
+
+	UPROPERTY(Config, EditAnywhere, meta = (Tooltip = "Memory, in megabytes, the textures sent to RPR should fit in. Once reached, the next textures are loaded from lower mips. 0 doesn't limit.", ClampMin = 0), Category = ImageManager)
+	int32			TextureMemoryBudget;
+
+	UPROPERTY(Config, EditAnywhere, meta = (Tooltip = "Width, in pixels, of the lat-long image built from sky light cubemaps. 0 uses twice the cubemap face size.", ClampMin = 0), Category = ImageManager)
+	int32			EnvironmentMapWidth;
+
 	bool			IsHybrid;
 	ERenderType		CurrentRenderType;
 
@@ -21,8 +21,12 @@
 
 DECLARE_LOG_CATEGORY_EXTERN(LogRPRTools, All, All);
 
-// Used to trace rendering steps
-DECLARE_LOG_CATEGORY_EXTERN(LogRPRTools_Step, Verbose, Verbose);
+// Used to trace rendering steps, enable with "log LogRPRTools_Step Verbose". Compiled out of shipping builds
+#if UE_BUILD_SHIPPING
+DECLARE_LOG_CATEGORY_EXTERN(LogRPRTools_Step, Log, Log);
+#else
+DECLARE_LOG_CATEGORY_EXTERN(LogRPRTools_Step, Log, Verbose);
+#endif
 
 class FRPRToolsModule : public IModuleInterface
 {
@@ -20,6 +20,7 @@
 #include <RadeonProRender.h>
 #include "FFrameBuffer.h"
 #include "FPostEffect.h"
+#include "Helpers/RPRApiStats.h"
 
 /*
  * Use typedefs to associate native types with clearer names (and respecting the UE4 norm)
@@ -64,5 +64,8 @@ public class RPRTools : ModuleRules
                 "RenderCore",
 				// ... add private dependencies that you statically link with here ...
 			});
+
+        // Counts and times the main RPR calls, see Helpers/RPRApiStats.h
+        PublicDefinitions.Add(Target.Configuration == UnrealTargetConfiguration.Shipping ? "RPR_API_STATS=0" : "RPR_API_STATS=1");
     }
 }
@@ -0,0 +1,1011 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+
+#include "RPRMockBackend.h"
+
+#if WITH_RPR_MOCK_BACKEND
+
+// The stubs below are the RPR entry points, export them from this module
+#define RPR_EXPORT_API
+#define RPRS_EXPORT_API
+
+#include "RadeonProRender.h"
+#include "RprLoadStore.h"
+#include "ProRenderGLTF.h"
+
+namespace
+{
+	enum class EMockObjectType : uint8
+	{
+		Context,
+		Scene,
+		Mesh,
+		Instance,
+		Camera,
+		Light,
+		Image,
+		FrameBuffer,
+		MaterialSystem,
+		MaterialNode,
+		PostEffect
+	};
+
+	struct FMockMaterialInput
+	{
+		rpr_uint		Key;
+		rpr_uint		Type;
+		TArray<uint8>	Value;
+	};
+
+	struct FMockObject
+	{
+		EMockObjectType				Type;
+		FString						Name;
+		rpr_uint					SubType;
+
+		// Context
+		rpr_creation_flags			CreationFlags;
+		TMap<rpr_aov, FMockObject*>	AOVs;
+
+		// Scene
+		TArray<rpr_shape>			Shapes;
+		TArray<rpr_light>			Lights;
+
+		// Shapes/lights/cameras
+		FMockObject*				BaseShape;
+		FMockObject*				Material;
+		float						Transform[16];
+		size_t						VertexCount;
+		size_t						FaceCount;
+
+		// Images/framebuffers
+		uint32						Width;
+		uint32						Height;
+		uint32						NumComponents;
+		TArray<uint8>				ImageData;
+		TArray<float>				PixelData;
+
+		// Material nodes
+		TArray<FMockMaterialInput>	Inputs;
+
+		FMockObject(EMockObjectType InType, rpr_uint InSubType = 0)
+			: Type(InType)
+			, SubType(InSubType)
+			, CreationFlags(0)
+			, BaseShape(nullptr)
+			, Material(nullptr)
+			, VertexCount(0)
+			, FaceCount(0)
+			, Width(0)
+			, Height(0)
+			, NumComponents(0)
+		{
+			FMemory::Memzero(Transform);
+			Transform[0] = Transform[5] = Transform[10] = Transform[15] = 1.0f;
+		}
+	};
+
+	template<typename T>
+	FMockObject* Cast(T Object)
+	{
+		return reinterpret_cast<FMockObject*>(Object);
+	}
+
+	template<typename T>
+	rpr_status Create(T* OutObject, EMockObjectType Type, rpr_uint SubType = 0)
+	{
+		if (OutObject == nullptr)
+		{
+			return RPR_ERROR_INVALID_PARAMETER;
+		}
+		*OutObject = reinterpret_cast<T>(new FMockObject(Type, SubType));
+		return RPR_SUCCESS;
+	}
+
+	rpr_status WriteInfo(const void* Source, size_t SourceSize, size_t Size, void* Data, size_t* SizeRet)
+	{
+		if (SizeRet != nullptr)
+		{
+			*SizeRet = SourceSize;
+		}
+		if (Data != nullptr)
+		{
+			if (Size < SourceSize)
+			{
+				return RPR_ERROR_INVALID_PARAMETER;
+			}
+			FMemory::Memcpy(Data, Source, SourceSize);
+		}
+		return RPR_SUCCESS;
+	}
+
+	template<typename T>
+	rpr_status WriteInfo(const T& Value, size_t Size, void* Data, size_t* SizeRet)
+	{
+		return WriteInfo(&Value, sizeof(T), Size, Data, SizeRet);
+	}
+
+	rpr_status WriteInfoString(const FString& Value, size_t Size, void* Data, size_t* SizeRet)
+	{
+		FTCHARToUTF8 converter(*Value);
+		TArray<ANSICHAR> buffer;
+		buffer.Append(converter.Get(), converter.Length());
+		buffer.Add('\0');
+		return WriteInfo(buffer.GetData(), buffer.Num(), Size, Data, SizeRet);
+	}
+
+	rpr_status GetCommonInfo(FMockObject* Object, rpr_uint Info, size_t Size, void* Data, size_t* SizeRet)
+	{
+		if (Object == nullptr)
+		{
+			return RPR_ERROR_INVALID_PARAMETER;
+		}
+		if (Info == RPR_OBJECT_NAME)
+		{
+			return WriteInfoString(Object->Name, Size, Data, SizeRet);
+		}
+		return RPR_ERROR_UNSUPPORTED;
+	}
+
+	rpr_status SetTransform(FMockObject* Object, rpr_bool Transpose, const rpr_float* Transform)
+	{
+		if (Object == nullptr || Transform == nullptr)
+		{
+			return RPR_ERROR_INVALID_PARAMETER;
+		}
+		for (int32 i = 0; i < 16; ++i)
+		{
+			Object->Transform[i] = Transpose ? Transform[(i % 4) * 4 + i / 4] : Transform[i];
+		}
+		return RPR_SUCCESS;
+	}
+
+	rpr_status SetMaterialInput(rpr_material_node Node, rpr_uint Key, rpr_uint Type, const void* Value, size_t ValueSize)
+	{
+		FMockObject* node = Cast(Node);
+		if (node == nullptr)
+		{
+			return RPR_ERROR_INVALID_PARAMETER;
+		}
+
+		FMockMaterialInput* input = node->Inputs.FindByPredicate([Key] (const FMockMaterialInput& Input) { return Input.Key == Key; });
+		if (input == nullptr)
+		{
+			input = &node->Inputs.AddDefaulted_GetRef();
+			input->Key = Key;
+		}
+		input->Type = Type;
+		input->Value.SetNumUninitialized(ValueSize);
+		FMemory::Memcpy(input->Value.GetData(), Value, ValueSize);
+		return RPR_SUCCESS;
+	}
+
+	uint32 GetComponentSize(rpr_component_type Type)
+	{
+		switch (Type)
+		{
+		case RPR_COMPONENT_TYPE_FLOAT16:	return 2;
+		case RPR_COMPONENT_TYPE_FLOAT32:	return 4;
+		default:							return 1;
+		}
+	}
+}
+
+extern "C"
+{
+
+rpr_int rprRegisterPlugin(rpr_char const* path)
+{
+	return 0;
+}
+
+rpr_status rprCreateContext(rpr_int api_version, rpr_int* pluginIDs, size_t pluginCount, rpr_creation_flags creation_flags, rpr_context_properties const* props, rpr_char const* cache_path, rpr_context* out_context)
+{
+
+	// Only the CPU "device" exists
+	if ((creation_flags & RPR_CREATION_FLAGS_ENABLE_CPU) == 0)
+	{
+		return RPR_ERROR_UNSUPPORTED;
+	}
+
+	rpr_status status = Create(out_context, EMockObjectType::Context);
+	if (status == RPR_SUCCESS)
+	{
+		Cast(*out_context)->CreationFlags = creation_flags;
+	}
+	return status;
+}
+
+rpr_status rprContextSetActivePlugin(rpr_context context, rpr_int pluginID)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextGetInfo(rpr_context context, rpr_context_info context_info, size_t size, void* data, size_t* size_ret)
+{
+
+	FMockObject* ctx = Cast(context);
+	if (ctx == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	switch (context_info)
+	{
+	case RPR_CONTEXT_CPU_NAME:
+		return WriteInfoString(TEXT("RPR Mock CPU"), size, data, size_ret);
+	case RPR_CONTEXT_CREATION_FLAGS:
+		return WriteInfo(ctx->CreationFlags, size, data, size_ret);
+	case RPR_CONTEXT_ACTIVE_PIXEL_COUNT:
+		return WriteInfo((rpr_uint) 0, size, data, size_ret);
+	case RPR_CONTEXT_LAST_ERROR_MESSAGE:
+	case RPR_CONTEXT_CACHE_PATH:
+		return WriteInfoString(FString(), size, data, size_ret);
+	default:
+		return GetCommonInfo(ctx, context_info, size, data, size_ret);
+	}
+}
+
+rpr_status rprContextSetParameterByKey1u(rpr_context context, rpr_context_info in_input, rpr_uint x)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetParameterByKey1f(rpr_context context, rpr_context_info in_input, rpr_float x)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetParameterByKeyString(rpr_context context, rpr_context_info in_input, rpr_char const* value)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetScene(rpr_context context, rpr_scene scene)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextSetAOV(rpr_context context, rpr_aov aov, rpr_framebuffer frame_buffer)
+{
+
+	FMockObject* ctx = Cast(context);
+	if (ctx == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	if (frame_buffer != nullptr)
+	{
+		ctx->AOVs.Add(aov, Cast(frame_buffer));
+	}
+	else
+	{
+		ctx->AOVs.Remove(aov);
+	}
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextRender(rpr_context context)
+{
+	FMockObject* ctx = Cast(context);
+	if (ctx == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	// Accumulate one constant sample so that resolved framebuffers hold a mid-grey image
+	for (const auto& aov : ctx->AOVs)
+	{
+		TArray<float>& pixels = aov.Value->PixelData;
+		for (int32 i = 0; i + 3 < pixels.Num(); i += 4)
+		{
+			pixels[i + 0] += 0.18f;
+			pixels[i + 1] += 0.18f;
+			pixels[i + 2] += 0.18f;
+			pixels[i + 3] += 1.0f;
+		}
+	}
+
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextRenderTile(rpr_context context, rpr_uint xmin, rpr_uint xmax, rpr_uint ymin, rpr_uint ymax)
+{
+	FMockObject* ctx = Cast(context);
+	if (ctx == nullptr || xmin >= xmax || ymin >= ymax)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	for (const auto& aov : ctx->AOVs)
+	{
+		FMockObject* frameBuffer = aov.Value;
+		const uint32 maxX = FMath::Min<uint32>(xmax, frameBuffer->Width);
+		const uint32 maxY = FMath::Min<uint32>(ymax, frameBuffer->Height);
+		for (uint32 y = ymin; y < maxY; ++y)
+		{
+			float* pixel = frameBuffer->PixelData.GetData() + (y * frameBuffer->Width + xmin) * 4;
+			for (uint32 x = xmin; x < maxX; ++x, pixel += 4)
+			{
+				pixel[0] += 0.18f;
+				pixel[1] += 0.18f;
+				pixel[2] += 0.18f;
+				pixel[3] += 1.0f;
+			}
+		}
+	}
+
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextResolveFrameBuffer(rpr_context context, rpr_framebuffer src_frame_buffer, rpr_framebuffer dst_frame_buffer, rpr_bool noDisplayGamma)
+{
+	FMockObject* src = Cast(src_frame_buffer);
+	FMockObject* dst = Cast(dst_frame_buffer);
+	if (src == nullptr || dst == nullptr || src->PixelData.Num() != dst->PixelData.Num())
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	for (int32 i = 0; i + 3 < src->PixelData.Num(); i += 4)
+	{
+		const float weight = src->PixelData[i + 3] > 0.0f ? 1.0f / src->PixelData[i + 3] : 0.0f;
+		dst->PixelData[i + 0] = src->PixelData[i + 0] * weight;
+		dst->PixelData[i + 1] = src->PixelData[i + 1] * weight;
+		dst->PixelData[i + 2] = src->PixelData[i + 2] * weight;
+		dst->PixelData[i + 3] = 1.0f;
+	}
+
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextClearMemory(rpr_context context)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextCreateImage(rpr_context context, rpr_image_format const format, rpr_image_desc const* image_desc, void const* data, rpr_image* out_image)
+{
+	if (image_desc == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	rpr_status status = Create(out_image, EMockObjectType::Image);
+	if (status != RPR_SUCCESS)
+	{
+		return status;
+	}
+
+	FMockObject* image = Cast(*out_image);
+	image->Width = image_desc->image_width;
+	image->Height = image_desc->image_height;
+	image->NumComponents = format.num_components;
+
+	const uint32 depth = FMath::Max<uint32>(1, image_desc->image_depth);
+	const uint64 byteCount = (uint64) image->Width * image->Height * depth * format.num_components * GetComponentSize(format.type);
+	if (data != nullptr)
+	{
+		image->ImageData.SetNumUninitialized(byteCount);
+		FMemory::Memcpy(image->ImageData.GetData(), data, byteCount);
+	}
+
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextCreateScene(rpr_context context, rpr_scene* out_scene)
+{
+	return Create(out_scene, EMockObjectType::Scene);
+}
+
+rpr_status rprContextCreateInstance(rpr_context context, rpr_shape shape, rpr_shape* out_instance)
+{
+
+	if (shape == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	rpr_status status = Create(out_instance, EMockObjectType::Instance);
+	if (status == RPR_SUCCESS)
+	{
+		Cast(*out_instance)->BaseShape = Cast(shape);
+	}
+	return status;
+}
+
+rpr_status rprContextCreateMesh(rpr_context context,
+	rpr_float const* vertices, size_t num_vertices, rpr_int vertex_stride,
+	rpr_float const* normals, size_t num_normals, rpr_int normal_stride,
+	rpr_float const* texcoords, size_t num_texcoords, rpr_int texcoord_stride,
+	rpr_int const* vertex_indices, rpr_int vidx_stride,
+	rpr_int const* normal_indices, rpr_int nidx_stride,
+	rpr_int const* texcoord_indices, rpr_int tidx_stride,
+	rpr_int const* num_face_vertices, size_t num_faces,
+	rpr_shape* out_mesh)
+{
+	rpr_status status = Create(out_mesh, EMockObjectType::Mesh);
+	if (status != RPR_SUCCESS)
+	{
+		return status;
+	}
+
+	FMockObject* mesh = Cast(*out_mesh);
+	mesh->VertexCount = num_vertices;
+	mesh->FaceCount = num_faces;
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextCreateCamera(rpr_context context, rpr_camera* out_camera)
+{
+	return Create(out_camera, EMockObjectType::Camera);
+}
+
+rpr_status rprContextCreateFrameBuffer(rpr_context context, rpr_framebuffer_format const format, rpr_framebuffer_desc const* fb_desc, rpr_framebuffer* out_fb)
+{
+	if (fb_desc == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	rpr_status status = Create(out_fb, EMockObjectType::FrameBuffer);
+	if (status != RPR_SUCCESS)
+	{
+		return status;
+	}
+
+	FMockObject* frameBuffer = Cast(*out_fb);
+	frameBuffer->Width = fb_desc->fb_width;
+	frameBuffer->Height = fb_desc->fb_height;
+	frameBuffer->NumComponents = 4;
+	frameBuffer->PixelData.SetNumZeroed(frameBuffer->Width * frameBuffer->Height * 4);
+
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextCreatePointLight(rpr_context context, rpr_light* out_light)
+{
+	return Create(out_light, EMockObjectType::Light, RPR_LIGHT_TYPE_POINT);
+}
+
+rpr_status rprContextCreateSpotLight(rpr_context context, rpr_light* out_light)
+{
+	return Create(out_light, EMockObjectType::Light, RPR_LIGHT_TYPE_SPOT);
+}
+
+rpr_status rprContextCreateDirectionalLight(rpr_context context, rpr_light* out_light)
+{
+	return Create(out_light, EMockObjectType::Light, RPR_LIGHT_TYPE_DIRECTIONAL);
+}
+
+rpr_status rprContextCreateEnvironmentLight(rpr_context context, rpr_light* out_light)
+{
+	return Create(out_light, EMockObjectType::Light, RPR_LIGHT_TYPE_ENVIRONMENT);
+}
+
+rpr_status rprContextCreateIESLight(rpr_context context, rpr_light* out_light)
+{
+	return Create(out_light, EMockObjectType::Light, RPR_LIGHT_TYPE_IES);
+}
+
+rpr_status rprContextCreateMaterialSystem(rpr_context in_context, rpr_material_system_type type, rpr_material_system* out_matsys)
+{
+	return Create(out_matsys, EMockObjectType::MaterialSystem, type);
+}
+
+rpr_status rprContextCreatePostEffect(rpr_context context, rpr_post_effect_type type, rpr_post_effect* out_effect)
+{
+	return Create(out_effect, EMockObjectType::PostEffect, type);
+}
+
+rpr_status rprContextAttachPostEffect(rpr_context context, rpr_post_effect effect)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprContextDetachPostEffect(rpr_context context, rpr_post_effect effect)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprPostEffectSetParameter1u(rpr_post_effect effect, rpr_char const* name, rpr_uint x)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprPostEffectSetParameter1f(rpr_post_effect effect, rpr_char const* name, rpr_float x)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprCameraGetInfo(rpr_camera camera, rpr_camera_info camera_info, size_t size, void* data, size_t* size_ret)
+{
+
+	FMockObject* cam = Cast(camera);
+	if (cam != nullptr && camera_info == RPR_CAMERA_TRANSFORM)
+	{
+		return WriteInfo(cam->Transform, sizeof(cam->Transform), size, data, size_ret);
+	}
+	return GetCommonInfo(cam, camera_info, size, data, size_ret);
+}
+
+rpr_status rprCameraLookAt(rpr_camera camera, rpr_float posx, rpr_float posy, rpr_float posz, rpr_float atx, rpr_float aty, rpr_float atz, rpr_float upx, rpr_float upy, rpr_float upz)
+{
+
+	FMockObject* cam = Cast(camera);
+	if (cam == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	cam->Transform[12] = posx;
+	cam->Transform[13] = posy;
+	cam->Transform[14] = posz;
+	return RPR_SUCCESS;
+}
+
+rpr_status rprCameraSetMode(rpr_camera camera, rpr_camera_mode mode)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprCameraSetExposure(rpr_camera camera, rpr_float exposure)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprCameraSetFStop(rpr_camera camera, rpr_float fstop)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprCameraSetFocalLength(rpr_camera camera, rpr_float flength)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprCameraSetFocusDistance(rpr_camera camera, rpr_float fdist)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprCameraSetSensorSize(rpr_camera camera, rpr_float width, rpr_float height)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprDirectionalLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprDirectionalLightSetShadowSoftnessAngle(rpr_light light, rpr_float softnessAngle)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprEnvironmentLightSetImage(rpr_light env_light, rpr_image image)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprEnvironmentLightSetIntensityScale(rpr_light env_light, rpr_float intensity_scale)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprFrameBufferClear(rpr_framebuffer frame_buffer)
+{
+	FMockObject* frameBuffer = Cast(frame_buffer);
+	if (frameBuffer == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	FMemory::Memzero(frameBuffer->PixelData.GetData(), frameBuffer->PixelData.Num() * sizeof(float));
+
+	return RPR_SUCCESS;
+}
+
+rpr_status rprFrameBufferGetInfo(rpr_framebuffer framebuffer, rpr_framebuffer_info info, size_t size, void* data, size_t* size_ret)
+{
+	FMockObject* frameBuffer = Cast(framebuffer);
+	if (frameBuffer != nullptr && info == RPR_FRAMEBUFFER_DATA)
+	{
+		const size_t byteCount = frameBuffer->PixelData.Num() * sizeof(float);
+		return WriteInfo(frameBuffer->PixelData.GetData(), byteCount, size, data, size_ret);
+	}
+
+	return GetCommonInfo(frameBuffer, info, size, data, size_ret);
+}
+
+rpr_status rprFrameBufferSaveToFile(rpr_framebuffer frame_buffer, rpr_char const* file_path)
+{
+	return RPR_ERROR_UNSUPPORTED;
+}
+
+rpr_status rprIESLightSetImageFromFile(rpr_light env_light, rpr_char const* imagePath, rpr_int nx, rpr_int ny)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprIESLightSetImageFromIESdata(rpr_light env_light, rpr_char const* iesData, rpr_int nx, rpr_int ny)
+{
+	return iesData != nullptr ? RPR_SUCCESS : RPR_ERROR_INVALID_PARAMETER;
+}
+
+rpr_status rprIESLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprImageGetInfo(rpr_image image, rpr_image_info image_info, size_t size, void* data, size_t* size_ret)
+{
+
+	FMockObject* img = Cast(image);
+	if (img != nullptr && image_info == RPR_IMAGE_DATA)
+	{
+		return WriteInfo(img->ImageData.GetData(), img->ImageData.Num(), size, data, size_ret);
+	}
+	return GetCommonInfo(img, image_info, size, data, size_ret);
+}
+
+rpr_status rprImageSetWrap(rpr_image image, rpr_image_wrap_type type)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprInstanceGetBaseShape(rpr_shape shape, rpr_shape* out_shape)
+{
+
+	FMockObject* instance = Cast(shape);
+	if (instance == nullptr || out_shape == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	*out_shape = reinterpret_cast<rpr_shape>(instance->BaseShape);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprLightGetInfo(rpr_light light, rpr_light_info info, size_t size, void* data, size_t* size_ret)
+{
+
+	FMockObject* lightObject = Cast(light);
+	if (lightObject != nullptr)
+	{
+		switch (info)
+		{
+		case RPR_LIGHT_TYPE:
+			return WriteInfo((rpr_light_type) lightObject->SubType, size, data, size_ret);
+		case RPR_LIGHT_TRANSFORM:
+			return WriteInfo(lightObject->Transform, sizeof(lightObject->Transform), size, data, size_ret);
+		default:
+			break;
+		}
+	}
+	return GetCommonInfo(lightObject, info, size, data, size_ret);
+}
+
+rpr_status rprLightSetTransform(rpr_light light, rpr_bool transpose, rpr_float const* transform)
+{
+	return SetTransform(Cast(light), transpose, transform);
+}
+
+rpr_status rprMeshGetInfo(rpr_shape mesh, rpr_mesh_info mesh_info, size_t size, void* data, size_t* size_ret)
+{
+
+	FMockObject* meshObject = Cast(mesh);
+	if (meshObject != nullptr)
+	{
+		switch (mesh_info)
+		{
+		case RPR_MESH_POLYGON_COUNT:
+			return WriteInfo(meshObject->FaceCount, size, data, size_ret);
+		case RPR_MESH_VERTEX_COUNT:
+			return WriteInfo(meshObject->VertexCount, size, data, size_ret);
+		default:
+			break;
+		}
+	}
+	return GetCommonInfo(meshObject, mesh_info, size, data, size_ret);
+}
+
+rpr_status rprShapeGetInfo(rpr_shape shape, rpr_shape_info info, size_t size, void* data, size_t* size_ret)
+{
+
+	FMockObject* shapeObject = Cast(shape);
+	if (shapeObject != nullptr)
+	{
+		switch (info)
+		{
+		case RPR_SHAPE_TYPE:
+			return WriteInfo((rpr_shape_type) (shapeObject->Type == EMockObjectType::Instance ? RPR_SHAPE_TYPE_INSTANCE : RPR_SHAPE_TYPE_MESH), size, data, size_ret);
+		case RPR_SHAPE_MATERIAL:
+			return WriteInfo(reinterpret_cast<rpr_material_node>(shapeObject->Material), size, data, size_ret);
+		case RPR_SHAPE_TRANSFORM:
+			return WriteInfo(shapeObject->Transform, sizeof(shapeObject->Transform), size, data, size_ret);
+		default:
+			break;
+		}
+	}
+	return GetCommonInfo(shapeObject, info, size, data, size_ret);
+}
+
+rpr_status rprShapeSetMaterial(rpr_shape shape, rpr_material_node node)
+{
+
+	FMockObject* shapeObject = Cast(shape);
+	if (shapeObject == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	shapeObject->Material = Cast(node);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprShapeSetShadow(rpr_shape shape, rpr_bool casts_shadow)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprShapeSetTransform(rpr_shape shape, rpr_bool transpose, rpr_float const* transform)
+{
+	return SetTransform(Cast(shape), transpose, transform);
+}
+
+rpr_status rprShapeSetVisibility(rpr_shape shape, rpr_bool visible)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprMaterialSystemCreateNode(rpr_material_system in_matsys, rpr_material_node_type in_type, rpr_material_node* out_node)
+{
+	return Create(out_node, EMockObjectType::MaterialNode, in_type);
+}
+
+rpr_status rprMaterialNodeGetInfo(rpr_material_node in_node, rpr_material_node_info in_info, size_t in_size, void* in_data, size_t* out_size)
+{
+
+	FMockObject* node = Cast(in_node);
+	if (node != nullptr)
+	{
+		switch (in_info)
+		{
+		case RPR_MATERIAL_NODE_TYPE:
+			return WriteInfo((rpr_material_node_type) node->SubType, in_size, in_data, out_size);
+		case RPR_MATERIAL_NODE_INPUT_COUNT:
+			return WriteInfo((size_t) node->Inputs.Num(), in_size, in_data, out_size);
+		default:
+			break;
+		}
+	}
+	return GetCommonInfo(node, in_info, in_size, in_data, out_size);
+}
+
+rpr_status rprMaterialNodeGetInputInfo(rpr_material_node in_node, rpr_int in_input_idx, rpr_material_node_input_info in_info, size_t in_size, void* in_data, size_t* out_size)
+{
+
+	FMockObject* node = Cast(in_node);
+	if (node == nullptr || !node->Inputs.IsValidIndex(in_input_idx))
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	const FMockMaterialInput& input = node->Inputs[in_input_idx];
+	switch (in_info)
+	{
+	case RPR_MATERIAL_NODE_INPUT_NAME:
+		return WriteInfo(input.Key, in_size, in_data, out_size);
+	case RPR_MATERIAL_NODE_INPUT_TYPE:
+		return WriteInfo(input.Type, in_size, in_data, out_size);
+	case RPR_MATERIAL_NODE_INPUT_VALUE:
+		return WriteInfo(input.Value.GetData(), input.Value.Num(), in_size, in_data, out_size);
+	default:
+		return RPR_ERROR_UNSUPPORTED;
+	}
+}
+
+rpr_status rprMaterialNodeSetInputFByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_float in_value_x, rpr_float in_value_y, rpr_float in_value_z, rpr_float in_value_w)
+{
+	const rpr_float value[4] = { in_value_x, in_value_y, in_value_z, in_value_w };
+	return SetMaterialInput(in_node, in_input, RPR_MATERIAL_NODE_INPUT_TYPE_FLOAT4, value, sizeof(value));
+}
+
+rpr_status rprMaterialNodeSetInputImageDataByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_image image)
+{
+	return SetMaterialInput(in_node, in_input, RPR_MATERIAL_NODE_INPUT_TYPE_IMAGE, &image, sizeof(image));
+}
+
+rpr_status rprMaterialNodeSetInputNByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_material_node in_input_node)
+{
+	return SetMaterialInput(in_node, in_input, RPR_MATERIAL_NODE_INPUT_TYPE_NODE, &in_input_node, sizeof(in_input_node));
+}
+
+rpr_status rprMaterialNodeSetInputUByKey(rpr_material_node in_node, rpr_material_node_input in_input, rpr_uint in_value)
+{
+	return SetMaterialInput(in_node, in_input, RPR_MATERIAL_NODE_INPUT_TYPE_UINT, &in_value, sizeof(in_value));
+}
+
+rpr_status rprObjectDelete(void* obj)
+{
+
+	if (obj == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	delete Cast(obj);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprObjectSetName(void* node, rpr_char const* name)
+{
+
+	FMockObject* object = Cast(node);
+	if (object == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	object->Name = UTF8_TO_TCHAR(name);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSceneAttachLight(rpr_scene scene, rpr_light light)
+{
+
+	FMockObject* sceneObject = Cast(scene);
+	if (sceneObject == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	sceneObject->Lights.AddUnique(light);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSceneDetachLight(rpr_scene scene, rpr_light light)
+{
+
+	FMockObject* sceneObject = Cast(scene);
+	if (sceneObject == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	sceneObject->Lights.RemoveSingleSwap(light);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSceneAttachShape(rpr_scene scene, rpr_shape shape)
+{
+
+	FMockObject* sceneObject = Cast(scene);
+	if (sceneObject == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	sceneObject->Shapes.AddUnique(shape);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSceneDetachShape(rpr_scene scene, rpr_shape shape)
+{
+
+	FMockObject* sceneObject = Cast(scene);
+	if (sceneObject == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	sceneObject->Shapes.RemoveSingleSwap(shape);
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSceneClear(rpr_scene scene)
+{
+
+	FMockObject* sceneObject = Cast(scene);
+	if (sceneObject == nullptr)
+	{
+		return RPR_ERROR_INVALID_PARAMETER;
+	}
+
+	sceneObject->Shapes.Empty();
+	sceneObject->Lights.Empty();
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSceneGetInfo(rpr_scene scene, rpr_scene_info info, size_t size, void* data, size_t* size_ret)
+{
+
+	FMockObject* sceneObject = Cast(scene);
+	if (sceneObject != nullptr)
+	{
+		switch (info)
+		{
+		case RPR_SCENE_SHAPE_COUNT:
+			return WriteInfo((size_t) sceneObject->Shapes.Num(), size, data, size_ret);
+		case RPR_SCENE_LIGHT_COUNT:
+			return WriteInfo((size_t) sceneObject->Lights.Num(), size, data, size_ret);
+		case RPR_SCENE_SHAPE_LIST:
+			return WriteInfo(sceneObject->Shapes.GetData(), sceneObject->Shapes.Num() * sizeof(rpr_shape), size, data, size_ret);
+		case RPR_SCENE_LIGHT_LIST:
+			return WriteInfo(sceneObject->Lights.GetData(), sceneObject->Lights.Num() * sizeof(rpr_light), size, data, size_ret);
+		default:
+			break;
+		}
+	}
+	return GetCommonInfo(sceneObject, info, size, data, size_ret);
+}
+
+rpr_status rprSceneSetCamera(rpr_scene scene, rpr_camera camera)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSceneSetEnvironmentLight(rpr_scene scene, rpr_light light)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSpotLightSetConeShape(rpr_light light, rpr_float iangle, rpr_float oangle)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprSpotLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b)
+{
+	return RPR_SUCCESS;
+}
+
+rpr_status rprPointLightSetRadiantPower3f(rpr_light light, rpr_float r, rpr_float g, rpr_float b)
+{
+	return RPR_SUCCESS;
+}
+
+int rprsExport(char const* rprsFileName, rpr_context context, rpr_scene scene,
+	int extraCustomParam_int_number, char const** extraCustomParam_int_names, int const* extraCustomParam_int_values,
+	int extraCustomParam_float_number, char const** extraCustomParam_float_names, float const* extraCustomParam_float_values,
+	unsigned int exportFlags)
+{
+	return RPR_ERROR_UNSUPPORTED;
+}
+
+rpr_int rprExportToGLTF(char const* filename, rpr_context context, rpr_material_system materialSystem, const rpr_scene* scenes, size_t sceneCount, rpr_uint flags)
+{
+	return RPR_ERROR_UNSUPPORTED;
+}
+
+} // extern "C"
+
+#endif // WITH_RPR_MOCK_BACKEND
+
+namespace RPR
+{
+	namespace Mock
+	{
+		bool IsEnabled()
+		{
+			return WITH_RPR_MOCK_BACKEND != 0;
+		}
+	}
+}
@@ -54,10 +54,11 @@ FString FRPR_SDKModule::GetDLLsDirectory(FString sdk)
 	}
 
 	if (PLATFORM_LINUX) {
-		return
-			(sdk == TEXT("RadeonProRenderSDK"))
-			? FPaths::ConvertRelativePathToFull(FRPRPluginVersionModule::GetRPRPluginPath() + "/ThirdParty/RadeonProRenderSDK/RadeonProRender/binUbuntu18")
-			: FPaths::ConvertRelativePathToFull(FRPRPluginVersionModule::GetRPRPluginPath() + "/ThirdParty/RadeonProImageProcessingSDK/Ubuntu18");
+		if (sdk == TEXT("RadeonProRenderSDK"))
+			return FPaths::ConvertRelativePathToFull(FRPRPluginVersionModule::GetRPRPluginPath() + "/ThirdParty/RadeonProRenderSDK/RadeonProRender/binUbuntu18");
+
+		else if (sdk == TEXT("RadeonProImageProcessingSDK"))
+			return FPaths::ConvertRelativePathToFull(FRPRPluginVersionModule::GetRPRPluginPath() + "/ThirdParty/RadeonProImageProcessingSDK/Ubuntu18");
 	}
 
 	checkf(false, TEXT("Only Windows/Linux 64bits supported."));
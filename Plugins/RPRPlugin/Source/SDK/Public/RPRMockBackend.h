@@ -0,0 +1,33 @@
+/*************************************************************************
+* Copyright 2020 Advanced Micro Devices
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+*  http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*************************************************************************/
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/*
+* CPU-only stand-in for the subset of the RPR API used by the plugin.
+* Enabled by building with the RPR_MOCK_BACKEND=1 environment variable (see RPR_SDK.Build.cs):
+* the RPR libraries are not linked and every call succeeds without rendering anything.
+* Calls are counted by RPR::ApiStats (RPRApiStats.h), like with the real backend.
+*/
+namespace RPR
+{
+	namespace Mock
+	{
+		RPR_SDK_API bool	IsEnabled();
+	}
+}
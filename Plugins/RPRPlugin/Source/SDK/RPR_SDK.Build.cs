@@ -75,22 +75,45 @@ public class RPR_SDK : ModuleRules
             Path.Combine(RPR_SDK_Directory, @"RadeonProRender/inc"),
         });
 
-        if (Target.Platform == UnrealTargetPlatform.Win64)
+        // RPR_MOCK_BACKEND=1 replaces the RPR core libraries by the CPU-only stubs in RPRMockBackend.cpp
+        bool bMockBackend = Environment.GetEnvironmentVariable("RPR_MOCK_BACKEND") == "1";
+        if (bMockBackend)
+        {
+            PublicDefinitions.Add("WITH_RPR_MOCK_BACKEND=1");
+            Console.WriteLine("RPR_SDK: mock backend enabled, RPR libraries are not linked");
+        }
+        else if (Target.Platform == UnrealTargetPlatform.Win64)
         {
+            PublicDefinitions.Add("WITH_RPR_MOCK_BACKEND=0");
             AddWindowsStaticLibraries(Target);
             AddWindowsDynamicLibraries(Target);
         }
         else if (Target.Platform == UnrealTargetPlatform.Linux)
         {
+            PublicDefinitions.Add("WITH_RPR_MOCK_BACKEND=0");
             AddLinuxDynamicLibraries(Target);
         }
         else
         {
+            PublicDefinitions.Add("WITH_RPR_MOCK_BACKEND=0");
             Console.WriteLine("warning: Platform '{0}' not supported!", Target.Platform);
         }
 
-        AddImageProcessingLibrary(Target);
-        AddOpenImageIOLibrary(Target);
+        // Windows delay-loads the image libraries, on Linux they're opened on first use and resolved at runtime
+        // (see RPRCoreSystemResources.cpp and ImageFilter/ImageFilterLibrary.h)
+        bool bLinkImageLibraries = !bMockBackend && Target.Platform == UnrealTargetPlatform.Win64;
+        PublicDefinitions.Add(bLinkImageLibraries ? "WITH_RPR_LINKED_IMAGE_LIBRARIES=1" : "WITH_RPR_LINKED_IMAGE_LIBRARIES=0");
+
+        if (bMockBackend)
+        {
+            // The denoiser code still compiles against the RIF headers, nothing is linked nor staged
+            PublicIncludePaths.Add(Path.Combine(ThirdPartyDirectory, @"RadeonProImageProcessingSDK/include"));
+        }
+        else
+        {
+            AddImageProcessingLibrary(Target);
+            AddOpenImageIOLibrary(Target);
+        }
     }
 
     private void AddLinuxDynamicLibraries(ReadOnlyTargetRules Target)
@@ -147,8 +170,9 @@ public class RPR_SDK : ModuleRules
         }
         else if (Target.Platform == UnrealTargetPlatform.Linux)
         {
-            PublicLibraryPaths.Add(Path.Combine(ThirdPartyDirectory, @"RadeonProImageProcessingSDK/Ubuntu18"));
-            PublicAdditionalLibraries.Add(Path.Combine(ThirdPartyDirectory, @"RadeonProImageProcessingSDK/Ubuntu18/libRadeonImageFilters64.so"));
+            // Not linked, a DT_NEEDED entry would load it with the editor: LoadImageFilterDLL opens it on first use.
+            // Its dependencies (OpenImageDenoise, MIOpen..) sit next to it and are staged with it.
+            RuntimeDependencies.Add(Path.Combine(ThirdPartyDirectory, @"RadeonProImageProcessingSDK/Ubuntu18/*.so*"));
         }
         else
         {
@@ -165,6 +189,10 @@ public class RPR_SDK : ModuleRules
             PublicAdditionalLibraries.Add(Path.Combine(ThirdPartyDirectory, @"RadeonProRenderSharedComponents/OpenImageIO/Windows/lib/OpenImageIO_RPR.lib"));
             PublicDelayLoadDLLs.Add("OpenImageIO_RPR.dll");
         }
+        else if (Target.Platform == UnrealTargetPlatform.Linux)
+        {
+            // OpenImageIO only has a C++ API, which can't be resolved at runtime: FImageSaver uses the engine image writers instead
+        }
         else
         {
             Console.WriteLine("warning: OpenImageIO Library doesn't support Platform '{0}'", Target.Platform);